@@ -0,0 +1,77 @@
+#include "AnimationClips.hpp"
+#include "spdlog/spdlog.h"
+#include <cmath>
+
+uint16_t AnimationClips::addClip(const std::string& name,
+                                 const std::vector<AnimationFrame>& frames,
+                                 AnimationLoopMode mode) {
+  if (frames.empty()) {
+    spdlog::error("[AnimationClips] clip {} has no frames", name);
+    return ANIMATION_CLIP_NONE;
+  }
+
+  uint16_t clip;
+  auto existing = m_clipIds.find(name);
+  if (existing != m_clipIds.end()) {
+    // the old table samples are left unused
+    clip = existing->second;
+  } else {
+    clip = static_cast<uint16_t>(m_durations.size());
+    m_clipIds.emplace(name, clip);
+    m_durations.push_back(0);
+    m_inverseDurations.push_back(0);
+    m_isLooping.push_back(0);
+    m_tableOffsets.push_back(0);
+    m_tableSizes.push_back(0);
+  }
+
+  const uint16_t firstRect = static_cast<uint16_t>(m_frameRects.size());
+  for (const auto& frame : frames) {
+    m_frameRects.push_back(frame.srcRect);
+  }
+
+  // frame order of one cycle: ping-pong goes back without repeating the ends
+  std::vector<uint16_t> sequence;
+  for (uint16_t i = 0; i < frames.size(); i++) {
+    sequence.push_back(i);
+  }
+  if (mode == ANIMATION_PING_PONG) {
+    for (int i = static_cast<int>(frames.size()) - 2; i > 0; i--) {
+      sequence.push_back(static_cast<uint16_t>(i));
+    }
+  }
+
+  const uint32_t tableOffset = static_cast<uint32_t>(m_frameTable.size());
+  for (uint16_t frame : sequence) {
+    const uint32_t numSamples = std::max(
+        1u, static_cast<uint32_t>(
+                std::lround(frames[frame].duration * ANIMATION_TABLE_RATE)));
+    m_frameTable.insert(m_frameTable.end(), numSamples,
+                        static_cast<uint16_t>(firstRect + frame));
+  }
+
+  m_tableOffsets[clip] = tableOffset;
+  m_tableSizes[clip] = static_cast<uint32_t>(m_frameTable.size()) - tableOffset;
+  m_durations[clip] = m_tableSizes[clip] / ANIMATION_TABLE_RATE;
+  m_inverseDurations[clip] = 1.0f / m_durations[clip];
+  m_isLooping[clip] = mode != ANIMATION_ONCE;
+  return clip;
+}
+
+uint16_t AnimationClips::addSheetClip(const std::string& name,
+                                      SDL_Rect firstFrame, uint16_t numFrames,
+                                      float framesPerSecond,
+                                      AnimationLoopMode mode) {
+  std::vector<AnimationFrame> frames;
+  for (uint16_t i = 0; i < numFrames; i++) {
+    SDL_Rect srcRect = firstFrame;
+    srcRect.x += i * firstFrame.w;
+    frames.push_back({srcRect, 1.0f / framesPerSecond});
+  }
+  return addClip(name, frames, mode);
+}
+
+uint16_t AnimationClips::getClipId(const std::string& name) const {
+  auto clip = m_clipIds.find(name);
+  return clip != m_clipIds.end() ? clip->second : ANIMATION_CLIP_NONE;
+}
@@ -0,0 +1,102 @@
+#ifndef ANIMATIONCLIPS_HPP
+#define ANIMATIONCLIPS_HPP
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Samples per second of the precomputed frame tables (one per millisecond).
+const float ANIMATION_TABLE_RATE = 1000.0f;
+// Clip id returned when a clip cannot be found or created.
+const uint16_t ANIMATION_CLIP_NONE = 0xffff;
+
+enum AnimationLoopMode {
+  // Plays once and holds the last frame.
+  ANIMATION_ONCE,
+  // Restarts from the first frame.
+  ANIMATION_LOOP,
+  // Plays forward, then backward, then forward again...
+  ANIMATION_PING_PONG
+};
+
+struct AnimationFrame {
+    // Source rectangle, relative to the sprite asset.
+    SDL_Rect srcRect;
+    // Time (in seconds) the frame stays on screen.
+    float duration;
+};
+
+/**
+ * Clip definitions shared by every animated entity, stored once as a resource.
+ * Each clip is precomputed into a frame table sampled every millisecond, so
+ * finding the frame shown at a given time is one multiply and two array reads
+ * whatever the frame durations. Ping-pong clips are unrolled into their table
+ * and loop like regular clips. Per-clip data is kept in parallel arrays so the
+ * `AnimationSystem` loop only touches what it reads.
+ */
+class AnimationClips {
+  private:
+    std::unordered_map<std::string, uint16_t> m_clipIds;
+
+    // Per clip: duration of one cycle, in seconds, and its inverse.
+    std::vector<float> m_durations;
+    std::vector<float> m_inverseDurations;
+    // Per clip: 1 for looping and ping-pong clips, 0 for one-shot clips.
+    std::vector<uint8_t> m_isLooping;
+    // Per clip: first sample and number of samples in `m_frameTable`.
+    std::vector<uint32_t> m_tableOffsets;
+    std::vector<uint32_t> m_tableSizes;
+
+    // Frame shown at each sample of every clip, index into `m_frameRects`.
+    std::vector<uint16_t> m_frameTable;
+    std::vector<SDL_Rect> m_frameRects;
+
+  public:
+    /**
+     * Adds (or replaces) the clip `name` and returns its id. Returns
+     * `ANIMATION_CLIP_NONE` (and logs) if `frames` is empty.
+     */
+    uint16_t addClip(const std::string& name,
+                     const std::vector<AnimationFrame>& frames,
+                     AnimationLoopMode mode);
+
+    /**
+     * Adds a clip of `numFrames` frames laid out left to right in a sprite
+     * sheet, starting at `firstFrame`, each shown for 1 / `framesPerSecond`.
+     */
+    uint16_t addSheetClip(const std::string& name, SDL_Rect firstFrame,
+                          uint16_t numFrames, float framesPerSecond,
+                          AnimationLoopMode mode);
+
+    // Id of the clip `name`, or `ANIMATION_CLIP_NONE`.
+    uint16_t getClipId(const std::string& name) const;
+
+    size_t getNumClips() const { return m_durations.size(); }
+    float getDuration(uint16_t clip) const { return m_durations[clip]; }
+
+    /**
+     * Time of the clip after it played for `time` seconds: wrapped into the
+     * cycle for looping clips, clamped to the end for one-shot clips. `time`
+     * is never negative, so truncating counts the completed cycles. `clip`
+     * must be below `getNumClips()`, as for `getFrameRect`.
+     */
+    float wrapTime(uint16_t clip, float time) const {
+      const float duration = m_durations[clip];
+      const float numCycles =
+          static_cast<float>(static_cast<int>(time * m_inverseDurations[clip]));
+      const float wrapped = time - duration * numCycles;
+      return m_isLooping[clip] ? wrapped : std::min(time, duration);
+    }
+
+    // Source rectangle of the frame shown at `time` (as from `wrapTime`).
+    const SDL_Rect& getFrameRect(uint16_t clip, float time) const {
+      const uint32_t sample =
+          std::min(static_cast<uint32_t>(time * ANIMATION_TABLE_RATE),
+                   m_tableSizes[clip] - 1);
+      return m_frameRects[m_frameTable[m_tableOffsets[clip] + sample]];
+    }
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "AssetArchive.hpp"
+#include "spdlog/spdlog.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+AssetArchive::~AssetArchive() { close(); }
+
+bool AssetArchive::open(const std::string& filePath) {
+  close();
+  const int file = ::open(filePath.c_str(), O_RDONLY);
+  if (file < 0) {
+    spdlog::error("[AssetArchive] Failed to open {}: {}", filePath,
+                  std::strerror(errno));
+    return false;
+  }
+  struct stat status;
+  if (fstat(file, &status) != 0 ||
+      static_cast<size_t>(status.st_size) < sizeof(ArchiveHeader)) {
+    spdlog::error("[AssetArchive] {} is not an asset archive", filePath);
+    ::close(file);
+    return false;
+  }
+  const size_t size = static_cast<size_t>(status.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+  // the mapping keeps the file alive
+  ::close(file);
+  if (data == MAP_FAILED) {
+    spdlog::error("[AssetArchive] Failed to map {}: {}", filePath,
+                  std::strerror(errno));
+    return false;
+  }
+  m_data = static_cast<const uint8_t*>(data);
+  m_size = size;
+
+  const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(m_data);
+  const uint64_t namesOffset =
+      sizeof(ArchiveHeader) +
+      static_cast<uint64_t>(header->numEntries) * sizeof(ArchiveEntry);
+  if (std::memcmp(header->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 ||
+      header->version != ARCHIVE_VERSION ||
+      namesOffset + header->namesSize > m_size) {
+    spdlog::error("[AssetArchive] {} is not a version {} asset archive",
+                  filePath, ARCHIVE_VERSION);
+    close();
+    return false;
+  }
+
+  const ArchiveEntry* entries =
+      reinterpret_cast<const ArchiveEntry*>(m_data + sizeof(ArchiveHeader));
+  const char* names = reinterpret_cast<const char*>(m_data + namesOffset);
+  m_index.reserve(header->numEntries);
+  for (uint32_t i = 0; i < header->numEntries; i++) {
+    const ArchiveEntry& entry = entries[i];
+    if (static_cast<uint64_t>(entry.nameOffset) + entry.nameSize >
+            header->namesSize ||
+        entry.offset + entry.size > m_size ||
+        (entry.type == ARCHIVE_TEXTURE &&
+         entry.size < static_cast<uint64_t>(entry.width) * entry.height * 4)) {
+      spdlog::error("[AssetArchive] {} has a corrupt entry {}", filePath, i);
+      close();
+      return false;
+    }
+    m_index.emplace(std::string(names + entry.nameOffset, entry.nameSize),
+                    &entry);
+  }
+
+  // textures are read right after the level starts loading
+  madvise(data, size, MADV_WILLNEED);
+  spdlog::info("[AssetArchive] Mapped {} entries ({} bytes) from {}",
+               header->numEntries, size, filePath);
+  return true;
+}
+
+void AssetArchive::close() {
+  if (m_data) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_index.clear();
+}
+
+const ArchiveEntry* AssetArchive::find(const std::string& filePath) const {
+  if (m_index.empty()) {
+    return nullptr;
+  }
+  size_t start = 0;
+  while (start < filePath.size()) {
+    auto entry = m_index.find(filePath.substr(start));
+    if (entry != m_index.end()) {
+      return entry->second;
+    }
+    start = filePath.find('/', start);
+    if (start == std::string::npos) {
+      break;
+    }
+    start++;
+  }
+  return nullptr;
+}
@@ -0,0 +1,88 @@
+#ifndef ASSETARCHIVE_HPP
+#define ASSETARCHIVE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/*
+ * Archive written by the asset packer (tools/AssetPacker.cpp), in the byte
+ * order of the machine that packed it:
+ *
+ *   ArchiveHeader
+ *   ArchiveEntry[numEntries]
+ *   entry names, back to back, not terminated
+ *   entry data, each aligned to ARCHIVE_ALIGNMENT
+ */
+const char ARCHIVE_MAGIC[4] = {'F', 'L', 'P', 'K'};
+const uint32_t ARCHIVE_VERSION = 1;
+const uint64_t ARCHIVE_ALIGNMENT = 64;
+
+enum ArchiveEntryType : uint32_t {
+  // Decoded pixels, `width * 4` bytes per row in SDL_PIXELFORMAT_RGBA32.
+  ARCHIVE_TEXTURE,
+  // Map file, as `Tilemap::loadFromMemory` reads it.
+  ARCHIVE_TILEMAP,
+  // Sound file, as is.
+  ARCHIVE_AUDIO,
+};
+
+struct ArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t numEntries;
+    uint32_t namesSize;
+};
+
+struct ArchiveEntry {
+    // Data, from the start of the archive.
+    uint64_t offset;
+    uint64_t size;
+    // Name, from the start of the names.
+    uint32_t nameOffset;
+    uint32_t nameSize;
+    uint32_t type;
+    // Texture size in pixels, 0 for other types.
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+};
+
+/**
+ * Read-only view of an asset archive mapped in memory: the data of an entry
+ * is read straight from the mapping, so loading it copies and decodes
+ * nothing. Entries are named by their path under the packed directory, like
+ * "images/tree.png".
+ */
+class AssetArchive {
+  private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::unordered_map<std::string, const ArchiveEntry*> m_index;
+
+  public:
+    AssetArchive() = default;
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+    ~AssetArchive();
+
+    // Maps the archive file. Returns false (and logs) if it is not valid.
+    bool open(const std::string& filePath);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    size_t getNumEntries() const { return m_index.size(); }
+
+    /**
+     * Entry of a file path, or null. The path matches the entry named by its
+     * longest suffix starting after a '/', so "../assets/images/tree.png"
+     * finds "images/tree.png" wherever the assets were packed from.
+     */
+    const ArchiveEntry* find(const std::string& filePath) const;
+
+    const uint8_t* getData(const ArchiveEntry& entry) const {
+      return m_data + entry.offset;
+    }
+};
+
+#endif
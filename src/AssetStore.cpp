@@ -1,7 +1,72 @@
 #include "AssetStore.hpp"
-#include "SDL2/SDL_render.h"
+#include "AssetArchive.hpp"
+#include "render/RenderThread.hpp"
 #include "spdlog/spdlog.h"
+#include "utils/Log.hpp"
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <limits>
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+
+// Texture memory of a page: the devices store 4 bytes per pixel.
+static uint64_t getPageSize(int width, int height) {
+  return static_cast<uint64_t>(width) * height * 4;
+}
+
+/*
+ * Run-length encodes the pixels of an RGBA32 surface as (run length, pixel)
+ * pairs. Atlas pages are mostly transparent padding and sprite backgrounds,
+ * which collapse into long runs. Returns nothing if the runs would take more
+ * memory than the raw pixels, as for noisy images.
+ */
+static std::vector<uint32_t> compressPixels(SDL_Surface* surface) {
+  const size_t numPixels = static_cast<size_t>(surface->w) * surface->h;
+  std::vector<uint32_t> runs;
+  SDL_LockSurface(surface);
+  for (int y = 0; y < surface->h; y++) {
+    const uint32_t* row = reinterpret_cast<const uint32_t*>(
+        static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch);
+    for (int x = 0; x < surface->w; x++) {
+      if (!runs.empty() && runs[runs.size() - 1] == row[x]) {
+        runs[runs.size() - 2]++;
+      } else if (runs.size() + 2 > numPixels) {
+        SDL_UnlockSurface(surface);
+        return {};
+      } else {
+        runs.push_back(1);
+        runs.push_back(row[x]);
+      }
+    }
+  }
+  SDL_UnlockSurface(surface);
+  runs.shrink_to_fit();
+  return runs;
+}
+
+// Writes pixels encoded by `compressPixels` into a surface of the same size.
+static void decompressPixels(const std::vector<uint32_t>& runs,
+                             SDL_Surface* surface) {
+  SDL_LockSurface(surface);
+  int x = 0;
+  int y = 0;
+  uint32_t* row = static_cast<uint32_t*>(surface->pixels);
+  for (size_t i = 0; i < runs.size(); i += 2) {
+    for (uint32_t n = 0; n < runs[i]; n++) {
+      row[x] = runs[i + 1];
+      if (++x == surface->w) {
+        x = 0;
+        y++;
+        uint8_t* rowBytes = static_cast<uint8_t*>(surface->pixels);
+        row = reinterpret_cast<uint32_t*>(rowBytes + y * surface->pitch);
+      }
+    }
+  }
+  SDL_UnlockSurface(surface);
+}
 
 AssetStore::AssetStore() { spdlog::info("AssetStore initialized."); }
 
@@ -11,24 +76,568 @@ AssetStore::~AssetStore() {
 }
 
 void AssetStore::clearAssets() {
-  for (auto texture : m_textures) {
-    SDL_DestroyTexture(texture.second);
+  // images still decoding would otherwise end up in the next level
+  m_decoder.wait();
+  m_decoder.collect(m_decodedImages);
+  for (auto& image : m_decodedImages) {
+    SDL_FreeSurface(image.surface);
+  }
+
+  if (m_numTextureBytes > 0) {
+    withDevice([this](RenderDevice& device) {
+      for (const auto& page : m_pages) {
+        if (page.texture != NULL_TEXTURE) {
+          device.destroyTexture(page.texture);
+        }
+      }
+    });
+  }
+  for (auto& pending : m_pendingSurfaces) {
+    SDL_FreeSurface(pending.surface);
+  }
+  for (auto& page : m_pages) {
+    SDL_FreeSurface(page.pendingSurface);
   }
 
+  m_pages.clear();
+  m_numTextureBytes = 0;
+  m_loads.clear();
+  m_decodedImages.clear();
+  m_pendingSurfaces.clear();
+  m_uploadQueue.clear();
+  m_pendingFonts.clear();
   m_textures.clear();
+  m_fonts.clear();
 }
 
-void AssetStore::addTexture(SDL_Renderer* renderer, const std::string& assetId,
+AssetHandle AssetStore::loadTexture(const std::string& assetId,
+                                    const std::string& filePath) {
+  const AssetHandle handle = static_cast<AssetHandle>(m_loads.size());
+  m_loads.push_back({assetId, filePath, false});
+  SDL_Surface* surface = getArchivedSurface(filePath);
+  if (surface) {
+    m_pendingSurfaces.push_back({assetId, filePath, surface});
+  } else {
+    m_decoder.decode(handle, filePath);
+  }
+  spdlog::info("[AssetStore] New texture added to the AssetStore with id={}",
+               assetId);
+  return handle;
+}
+
+void AssetStore::addTexture(const std::string& assetId,
                             const std::string& filePath) {
-  SDL_Surface* surface = IMG_Load(filePath.c_str());
-  SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-  SDL_FreeSurface(surface);
+  loadTexture(assetId, filePath);
+}
 
-  m_textures.emplace(assetId, texture);
-  spdlog::info("[AssetStore] New texture added to the AssetStore with id={}",
+// Id under which a glyph is packed, until its font picks it up.
+static std::string getGlyphAssetId(const std::string& fontId, char c) {
+  return fontId + '#' + c;
+}
+
+void AssetStore::addFont(const std::string& assetId,
+                         const std::string& filePath, int fontSize) {
+  TTF_Font* ttfFont = TTF_OpenFont(filePath.c_str(), fontSize);
+  if (!ttfFont) {
+    spdlog::error("[AssetStore] Failed to load font {}: {}", filePath,
+                  TTF_GetError());
+    return;
+  }
+
+  Font font;
+  font.height = TTF_FontHeight(ttfFont);
+  font.ascent = TTF_FontAscent(ttfFont);
+  font.lineSkip = TTF_FontLineSkip(ttfFont);
+  font.glyphs.resize(FONT_NUM_GLYPHS);
+  font.kerning.resize(FONT_NUM_GLYPHS * FONT_NUM_GLYPHS);
+  for (int i = 0; i < FONT_NUM_GLYPHS; i++) {
+    const char c = static_cast<char>(FONT_FIRST_GLYPH + i);
+    FontGlyph& glyph = font.glyphs[i];
+    glyph.region = {NULL_TEXTURE, {0, 0, 0, 0}, 0};
+    int minX, maxX, minY, maxY;
+    if (TTF_GlyphMetrics(ttfFont, c, &minX, &maxX, &minY, &maxY,
+                         &glyph.advance) != 0) {
+      glyph.offsetX = 0;
+      glyph.advance = 0;
+      continue;
+    }
+    // SDL_ttf shifts the image right when the glyph reaches left of the pen
+    glyph.offsetX = std::min(minX, 0);
+
+    for (int j = 0; j < FONT_NUM_GLYPHS; j++) {
+      font.kerning[i * FONT_NUM_GLYPHS + j] =
+          static_cast<int8_t>(TTF_GetFontKerningSizeGlyphs(
+              ttfFont, c, static_cast<char>(FONT_FIRST_GLYPH + j)));
+    }
+
+    if (maxX <= minX) {
+      continue;
+    }
+    // white, so the color of each text can be applied as a color mod
+    SDL_Surface* surface =
+        TTF_RenderGlyph_Blended(ttfFont, c, SDL_Color{255, 255, 255, 255});
+    if (!surface) {
+      spdlog::error("[AssetStore] Failed to render glyph '{}' of {}: {}", c,
+                    filePath, TTF_GetError());
+      continue;
+    }
+    m_pendingSurfaces.push_back({getGlyphAssetId(assetId, c), "", surface});
+  }
+  TTF_CloseFont(ttfFont);
+
+  m_fonts[assetId] = std::move(font);
+  m_pendingFonts.push_back(assetId);
+  spdlog::info("[AssetStore] New font added to the AssetStore with id={}",
                assetId);
 }
 
-SDL_Texture* AssetStore::getTexture(const std::string& assetId) const {
-  return m_textures.at(assetId);
-}
\ No newline at end of file
+void AssetStore::withDevice(const std::function<void(RenderDevice&)>& task) {
+  if (m_renderThread && m_renderThread->isRunning()) {
+    m_renderThread->runOnDevice(task);
+  } else {
+    task(*m_device);
+  }
+}
+
+SDL_Surface* AssetStore::getArchivedSurface(
+    const std::string& filePath) const {
+  if (!m_archive) {
+    return nullptr;
+  }
+  const ArchiveEntry* entry = m_archive->find(filePath);
+  if (!entry || entry->type != ARCHIVE_TEXTURE) {
+    return nullptr;
+  }
+  // only read: blits and texture uploads never write to their source
+  void* pixels = const_cast<uint8_t*>(m_archive->getData(*entry));
+  SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(
+      pixels, static_cast<int>(entry->width), static_cast<int>(entry->height),
+      32, static_cast<int>(entry->width) * 4, SDL_PIXELFORMAT_RGBA32);
+  if (!surface) {
+    spdlog::error("[AssetStore] Failed to read packed texture {}: {}",
+                  filePath, SDL_GetError());
+  }
+  return surface;
+}
+
+void AssetStore::cachePixels(TexturePage& page, SDL_Surface* surface) {
+  // without budget, nothing is evicted and the cache would never be read
+  if (isPixelCacheEnabled && textureBudget > 0 && !page.isPinned &&
+      !page.isIncompressible && page.cachedPixels.empty()) {
+    if (surface->format->format == SDL_PIXELFORMAT_RGBA32) {
+      page.cachedPixels = compressPixels(surface);
+    } else {
+      SDL_Surface* converted =
+          SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+      if (!converted) {
+        return;
+      }
+      page.cachedPixels = compressPixels(converted);
+      SDL_FreeSurface(converted);
+    }
+    page.isIncompressible = page.cachedPixels.empty();
+  }
+}
+
+void AssetStore::finishUpload(TexturePage& page) {
+  if (page.texture == NULL_TEXTURE) {
+    // no memory to count, and retrying on every lookup would fail again
+    spdlog::error("[AssetStore] Failed to create a {}x{} texture, {} assets "
+                  "will not be drawn",
+                  page.width, page.height, page.assetIds.size());
+    page.hasFailed = true;
+    for (const auto& assetId : page.assetIds) {
+      failLoads(assetId);
+    }
+    return;
+  }
+  for (const auto& assetId : page.assetIds) {
+    m_textures[assetId].texture = page.texture;
+  }
+  page.lastUsedFrame = m_frame;
+  m_numTextureBytes += getPageSize(page.width, page.height);
+}
+
+void AssetStore::uploadPage(TexturePage& page, SDL_Surface* surface) {
+  cachePixels(page, surface);
+  withDevice([&page, surface](RenderDevice& device) {
+    page.texture = device.createTexture(surface);
+  });
+  finishUpload(page);
+}
+
+void AssetStore::reloadPage(TexturePage& page) {
+  SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(
+      0, page.width, page.height, 32, SDL_PIXELFORMAT_RGBA32);
+  if (!surface) {
+    spdlog::error("[AssetStore] Failed to reload a {}x{} texture: {}",
+                  page.width, page.height, SDL_GetError());
+    return;
+  }
+  if (!page.cachedPixels.empty()) {
+    decompressPixels(page.cachedPixels, surface);
+  } else {
+    for (size_t i = 0; i < page.filePaths.size(); i++) {
+      SDL_Surface* image = getArchivedSurface(page.filePaths[i]);
+      if (!image) {
+        image = IMG_Load(page.filePaths[i].c_str());
+      }
+      if (!image) {
+        spdlog::error("[AssetStore] Failed to reload texture {}: {}",
+                      page.filePaths[i], IMG_GetError());
+        continue;
+      }
+      SDL_Rect dstRect = page.rects[i];
+      SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+      SDL_BlitSurface(image, NULL, surface, &dstRect);
+      SDL_FreeSurface(image);
+    }
+  }
+
+  uploadPage(page, surface);
+  SDL_FreeSurface(surface);
+  m_numReloads++;
+  LOG_DEBUG("[AssetStore] Reloaded a {}x{} texture ({})", page.width,
+            page.height, page.cachedPixels.empty() ? "files" : "cache");
+}
+
+bool AssetStore::collectDecoded() {
+  const bool wasEmpty = m_decodedImages.empty();
+  m_decoder.collect(m_decodedImages);
+  if (m_decodedImages.empty()) {
+    // font glyphs may still wait to be packed
+    return m_decoder.getNumPending() == 0;
+  }
+  const uint64_t now = SDL_GetPerformanceCounter();
+  if (wasEmpty) {
+    m_firstDecodedTime = now;
+  }
+  // a slow image, or a stream of new loads, does not hold the others back
+  const double waitedSeconds =
+      static_cast<double>(now - m_firstDecodedTime) /
+      static_cast<double>(SDL_GetPerformanceFrequency());
+  if (m_decoder.getNumPending() > 0 &&
+      m_decodedImages.size() < DECODED_PACK_BATCH_SIZE &&
+      waitedSeconds < DECODED_PACK_DELAY) {
+    return false;
+  }
+
+  // in request order, so a batch packs the same whatever the decoding order
+  std::sort(m_decodedImages.begin(), m_decodedImages.end(),
+            [](const DecodedImage& a, const DecodedImage& b) {
+              return a.id < b.id;
+            });
+  for (const auto& image : m_decodedImages) {
+    LoadRequest& load = m_loads[image.id];
+    if (!image.surface) {
+      load.hasFailed = true;
+      continue;
+    }
+    m_pendingSurfaces.push_back({load.assetId, load.filePath, image.surface});
+  }
+  m_decodedImages.clear();
+  return true;
+}
+
+void AssetStore::packPending() {
+  // called every frame once loads are done: allocate nothing then
+  if (m_pendingSurfaces.empty()) {
+    return;
+  }
+  std::vector<stbrp_rect> rects;
+  for (size_t i = 0; i < m_pendingSurfaces.size(); i++) {
+    PendingSurface& pending = m_pendingSurfaces[i];
+    const int paddedWidth = pending.surface->w + 2 * ATLAS_PADDING;
+    const int paddedHeight = pending.surface->h + 2 * ATLAS_PADDING;
+
+    if (paddedWidth > ATLAS_PAGE_SIZE || paddedHeight > ATLAS_PAGE_SIZE) {
+      // too large for a page: keep it as a standalone texture
+      const SDL_Rect rect = {0, 0, pending.surface->w, pending.surface->h};
+      TexturePage page = {};
+      page.width = rect.w;
+      page.height = rect.h;
+      page.isPinned = pending.filePath.empty();
+      page.assetIds.push_back(pending.assetId);
+      page.filePaths.push_back(pending.filePath);
+      page.rects.push_back(rect);
+      m_textures[pending.assetId] = {NULL_TEXTURE, rect,
+                                     static_cast<uint16_t>(m_pages.size())};
+      cachePixels(page, pending.surface);
+      page.pendingSurface = pending.surface;
+      pending.surface = nullptr;
+      m_uploadQueue.push_back(m_pages.size());
+      m_pages.push_back(std::move(page));
+      continue;
+    }
+
+    stbrp_rect rect = {};
+    rect.id = static_cast<int>(i);
+    rect.w = paddedWidth;
+    rect.h = paddedHeight;
+    rects.push_back(rect);
+  }
+
+  std::vector<stbrp_node> nodes(ATLAS_PAGE_SIZE);
+  while (!rects.empty()) {
+    stbrp_context context;
+    stbrp_init_target(&context, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, nodes.data(),
+                      static_cast<int>(nodes.size()));
+    stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()));
+
+    // shrink the page to the packed area
+    int pageWidth = 0;
+    int pageHeight = 0;
+    for (const auto& rect : rects) {
+      if (rect.was_packed) {
+        pageWidth = std::max(pageWidth, rect.x + rect.w);
+        pageHeight = std::max(pageHeight, rect.y + rect.h);
+      }
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(
+        0, pageWidth, pageHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
+      spdlog::error("[AssetStore] Failed to create a {}x{} atlas page: {}",
+                    pageWidth, pageHeight, SDL_GetError());
+    }
+    TexturePage page = {};
+    page.width = pageWidth;
+    page.height = pageHeight;
+    std::vector<stbrp_rect> unpacked;
+    for (const auto& rect : rects) {
+      if (!rect.was_packed) {
+        unpacked.push_back(rect);
+        continue;
+      }
+      if (!surface) {
+        failLoads(m_pendingSurfaces[rect.id].assetId);
+        continue;
+      }
+      const PendingSurface& pending = m_pendingSurfaces[rect.id];
+      const SDL_Rect dstRect = {rect.x + ATLAS_PADDING, rect.y + ATLAS_PADDING,
+                                pending.surface->w, pending.surface->h};
+
+      // copy the pixels as they are, alpha included
+      SDL_Rect blitRect = dstRect;
+      SDL_SetSurfaceBlendMode(pending.surface, SDL_BLENDMODE_NONE);
+      SDL_BlitSurface(pending.surface, NULL, surface, &blitRect);
+      page.isPinned = page.isPinned || pending.filePath.empty();
+      page.assetIds.push_back(pending.assetId);
+      page.filePaths.push_back(pending.filePath);
+      page.rects.push_back(dstRect);
+      m_textures[pending.assetId] = {NULL_TEXTURE, dstRect,
+                                     static_cast<uint16_t>(m_pages.size())};
+    }
+
+    if (!surface) {
+      rects.swap(unpacked);
+      continue;
+    }
+    const size_t numPacked = page.assetIds.size();
+    cachePixels(page, surface);
+    page.pendingSurface = surface;
+    m_uploadQueue.push_back(m_pages.size());
+    m_pages.push_back(std::move(page));
+    spdlog::info("[AssetStore] Atlas page {}x{} built with {} textures.",
+                 pageWidth, pageHeight, numPacked);
+
+    rects.swap(unpacked);
+  }
+
+  for (auto& pending : m_pendingSurfaces) {
+    SDL_FreeSurface(pending.surface);
+  }
+  m_pendingSurfaces.clear();
+}
+
+void AssetStore::uploadPages(double budgetSeconds) {
+  if (m_uploadQueue.empty()) {
+    return;
+  }
+
+  // one trip to the render thread for the whole batch
+  size_t numUploaded = 0;
+  withDevice([this, budgetSeconds, &numUploaded](RenderDevice& device) {
+    const uint64_t start = SDL_GetPerformanceCounter();
+    const double budgetTicks =
+        budgetSeconds * static_cast<double>(SDL_GetPerformanceFrequency());
+    for (size_t index : m_uploadQueue) {
+      if (numUploaded > 0 &&
+          SDL_GetPerformanceCounter() - start >= budgetTicks) {
+        break;
+      }
+      TexturePage& page = m_pages[index];
+      page.texture = device.createTexture(page.pendingSurface);
+      numUploaded++;
+    }
+  });
+
+  for (size_t i = 0; i < numUploaded; i++) {
+    TexturePage& page = m_pages[m_uploadQueue[i]];
+    SDL_FreeSurface(page.pendingSurface);
+    page.pendingSurface = nullptr;
+    finishUpload(page);
+  }
+  m_uploadQueue.erase(m_uploadQueue.begin(),
+                      m_uploadQueue.begin() + numUploaded);
+}
+
+void AssetStore::resolveFonts() {
+  if (!m_pendingSurfaces.empty() || !m_uploadQueue.empty()) {
+    return;
+  }
+
+  // glyphs are reached through their font only
+  for (const auto& fontId : m_pendingFonts) {
+    Font& font = m_fonts.at(fontId);
+    for (int i = 0; i < FONT_NUM_GLYPHS; i++) {
+      auto region = m_textures.find(
+          getGlyphAssetId(fontId, static_cast<char>(FONT_FIRST_GLYPH + i)));
+      if (region != m_textures.end()) {
+        font.glyphs[i].region = region->second;
+        m_textures.erase(region);
+      }
+    }
+    font.isReady = true;
+  }
+  m_pendingFonts.clear();
+}
+
+void AssetStore::buildAtlases(RenderDevice& device) {
+  m_device = &device;
+  m_decoder.wait();
+  collectDecoded();
+  packPending();
+  uploadPages(std::numeric_limits<double>::infinity());
+  resolveFonts();
+}
+
+void AssetStore::processLoads(double budgetSeconds) {
+  if (!m_device) {
+    return;
+  }
+  // images are packed in batches rather than one by one, for denser atlases
+  if (collectDecoded()) {
+    packPending();
+  }
+  uploadPages(budgetSeconds);
+  resolveFonts();
+}
+
+void AssetStore::failLoads(const std::string& assetId) {
+  for (auto& load : m_loads) {
+    if (load.assetId == assetId) {
+      load.hasFailed = true;
+    }
+  }
+}
+
+AssetLoadState AssetStore::getLoadState(AssetHandle handle) const {
+  const LoadRequest& load = m_loads.at(handle);
+  if (load.hasFailed) {
+    return ASSET_FAILED;
+  }
+  auto region = m_textures.find(load.assetId);
+  if (region == m_textures.end() ||
+      m_pages[region->second.page].pendingSurface) {
+    return ASSET_LOADING;
+  }
+  return ASSET_READY;
+}
+
+bool AssetStore::isLoading() {
+  return m_decoder.getNumPending() > 0 || !m_decodedImages.empty() ||
+         !m_pendingSurfaces.empty() || !m_uploadQueue.empty();
+}
+
+void AssetStore::update() {
+  m_frame++;
+  if (textureBudget == 0 || m_numTextureBytes <= textureBudget) {
+    return;
+  }
+
+  // the render thread may still draw the previous frame: keep its textures
+  const uint64_t minUnusedFrames = std::max<uint32_t>(evictionFrames, 2);
+  std::vector<TexturePage*> unused;
+  for (auto& page : m_pages) {
+    if (page.texture != NULL_TEXTURE && !page.isPinned &&
+        m_frame - page.lastUsedFrame >= minUnusedFrames) {
+      unused.push_back(&page);
+    }
+  }
+  std::sort(unused.begin(), unused.end(),
+            [](const TexturePage* a, const TexturePage* b) {
+              return a->lastUsedFrame < b->lastUsedFrame;
+            });
+
+  // least recently used first, until back under budget
+  std::vector<TexturePage*> evicted;
+  for (TexturePage* page : unused) {
+    if (m_numTextureBytes <= textureBudget) {
+      break;
+    }
+    evicted.push_back(page);
+    m_numTextureBytes -= getPageSize(page->width, page->height);
+  }
+  if (evicted.empty()) {
+    return;
+  }
+
+  withDevice([&evicted](RenderDevice& device) {
+    for (TexturePage* page : evicted) {
+      device.destroyTexture(page->texture);
+    }
+  });
+  for (TexturePage* page : evicted) {
+    // the device may give the handle to another texture
+    page->texture = NULL_TEXTURE;
+    for (const auto& assetId : page->assetIds) {
+      m_textures[assetId].texture = NULL_TEXTURE;
+    }
+    m_numEvictions++;
+  }
+  LOG_DEBUG("[AssetStore] Evicted {} textures, {} bytes left", evicted.size(),
+            m_numTextureBytes);
+}
+
+const TextureRegion& AssetStore::getTexture(const std::string& assetId) {
+  const TextureRegion& region = m_textures.at(assetId);
+  TexturePage& page = m_pages[region.page];
+  page.lastUsedFrame = m_frame;
+  if (page.pendingSurface) {
+    // needed before its turn in the upload queue
+    m_uploadQueue.erase(
+        std::find(m_uploadQueue.begin(), m_uploadQueue.end(), region.page));
+    uploadPage(page, page.pendingSurface);
+    SDL_FreeSurface(page.pendingSurface);
+    page.pendingSurface = nullptr;
+  } else if (page.texture == NULL_TEXTURE && !page.hasFailed) {
+    reloadPage(page);
+  }
+  return region;
+}
+
+const TextureRegion* AssetStore::findTexture(const std::string& assetId) {
+  auto it = m_textures.find(assetId);
+  if (it == m_textures.end()) {
+    return nullptr;
+  }
+  TexturePage& page = m_pages[it->second.page];
+  if (page.pendingSurface || page.hasFailed) {
+    return nullptr;
+  }
+  page.lastUsedFrame = m_frame;
+  if (page.texture == NULL_TEXTURE) {
+    reloadPage(page);
+  }
+  return page.texture != NULL_TEXTURE ? &it->second : nullptr;
+}
+
+const Font& AssetStore::getFont(const std::string& assetId) const {
+  return m_fonts.at(assetId);
+}
+
+const Font* AssetStore::findFont(const std::string& assetId) const {
+  auto it = m_fonts.find(assetId);
+  return it != m_fonts.end() ? &it->second : nullptr;
+}
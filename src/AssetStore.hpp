@@ -1,23 +1,295 @@
 #ifndef ASSETSTORE_HPP
 #define ASSETSTORE_HPP
+#include "ImageDecoder.hpp"
+#include "render/RenderDevice.hpp"
 #include <SDL2/SDL.h>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Side of the square atlas pages built by `AssetStore::buildAtlases`.
+const int ATLAS_PAGE_SIZE = 2048;
+// Transparent border kept around each image packed in an atlas.
+const int ATLAS_PADDING = 1;
+// Frames a texture stays unused before it may be evicted, by default.
+const uint32_t DEFAULT_TEXTURE_EVICTION_FRAMES = 300;
+// Seconds per frame spent creating the textures of loaded images, by default.
+const double DEFAULT_TEXTURE_UPLOAD_BUDGET = 0.004;
+/*
+ * Decoded images are packed together once every queued image is decoded, or
+ * once this many wait, or once the oldest waited this many seconds.
+ */
+const size_t DECODED_PACK_BATCH_SIZE = 64;
+const double DECODED_PACK_DELAY = 0.1;
+
+// Identifies a texture requested with `AssetStore::loadTexture`.
+typedef uint32_t AssetHandle;
+
+enum AssetLoadState { ASSET_LOADING, ASSET_READY, ASSET_FAILED };
+
+/*
+ * Location of an asset: the texture holding it and the sub-rectangle it
+ * occupies in that texture. Standalone textures cover the whole texture.
+ */
+struct TextureRegion {
+    TextureHandle texture;
+    SDL_Rect rect;
+    // Small index of `texture` in the store, used in render sort keys.
+    uint16_t page;
+};
+
+// First and last characters rasterized for each font: printable ASCII.
+const char FONT_FIRST_GLYPH = ' ';
+const char FONT_LAST_GLYPH = '~';
+const int FONT_NUM_GLYPHS = FONT_LAST_GLYPH - FONT_FIRST_GLYPH + 1;
+
+struct FontGlyph {
+    // Rendered glyph, a full line high; no texture for blank glyphs.
+    TextureRegion region;
+    // Horizontal offset of the image from the pen position.
+    int offsetX;
+    // Pen advance to the next glyph.
+    int advance;
+};
+
+/*
+ * Font rasterized at one size: its glyphs live in the atlas pages like any
+ * other texture, and its metrics and kerning pairs are copied out of SDL_ttf
+ * when it is loaded, so laying out text never calls SDL_ttf.
+ */
+struct Font {
+    int height;
+    int ascent;
+    // Distance between the tops of two lines.
+    int lineSkip;
+    std::vector<FontGlyph> glyphs;
+    // Kerning adjustment of every pair of glyphs, `[previous][next]`.
+    std::vector<int8_t> kerning;
+    // Whether the glyphs have their atlas regions yet, see `buildAtlases`.
+    bool isReady = false;
+
+    // Glyph of `c`; characters the font does not cover show as '?'.
+    const FontGlyph& getGlyph(char c) const {
+      if (c < FONT_FIRST_GLYPH || c > FONT_LAST_GLYPH) {
+        c = '?';
+      }
+      return glyphs[c - FONT_FIRST_GLYPH];
+    }
+
+    int getKerning(char previous, char next) const {
+      if (previous < FONT_FIRST_GLYPH || previous > FONT_LAST_GLYPH ||
+          next < FONT_FIRST_GLYPH || next > FONT_LAST_GLYPH) {
+        return 0;
+      }
+      return kerning[(previous - FONT_FIRST_GLYPH) * FONT_NUM_GLYPHS +
+                     (next - FONT_FIRST_GLYPH)];
+    }
+};
+
+class AssetArchive;
+class RenderThread;
 
 class AssetStore {
   private:
-    std::unordered_map<std::string, SDL_Texture*> m_textures;
-    // TODO: create collection of fonts
+    struct LoadRequest {
+        std::string assetId;
+        std::string filePath;
+        // Loading until decoded, then ready once its page is uploaded.
+        bool hasFailed;
+    };
+
+    struct PendingSurface {
+        std::string assetId;
+        // Image file the surface was decoded from, empty for font glyphs.
+        std::string filePath;
+        SDL_Surface* surface;
+    };
+
+    /*
+     * Texture owned by the store: an atlas page or an image too large for a
+     * page. An evicted page has no texture until its next use rebuilds it.
+     */
+    struct TexturePage {
+        TextureHandle texture;
+        int width;
+        int height;
+        uint64_t lastUsedFrame;
+        // Pages holding glyphs are never evicted: text layouts keep handles.
+        bool isPinned;
+        // Assets of the page, with their image files and rectangles.
+        std::vector<std::string> assetIds;
+        std::vector<std::string> filePaths;
+        std::vector<SDL_Rect> rects;
+        /*
+         * Pixels, run-length encoded, when `isPixelCacheEnabled` and smaller
+         * than the raw pixels.
+         */
+        std::vector<uint32_t> cachedPixels;
+        // Whether the run-length encoding was larger: not tried again.
+        bool isIncompressible;
+        // Whether the device failed to create the texture: not tried again.
+        bool hasFailed;
+        // Pixels of a page packed but not uploaded yet, in `m_uploadQueue`.
+        SDL_Surface* pendingSurface;
+    };
+
+    std::unordered_map<std::string, TextureRegion> m_textures;
+
+    // Device the textures were created on, by `buildAtlases`.
+    RenderDevice* m_device = nullptr;
+    // Thread owning the device once rendering started, if any.
+    RenderThread* m_renderThread = nullptr;
+    const AssetArchive* m_archive = nullptr;
+
+    // Every texture owned by the store, indexed by `TextureRegion::page`.
+    std::vector<TexturePage> m_pages;
+    // Texture memory used by the pages on the device.
+    uint64_t m_numTextureBytes = 0;
+    uint64_t m_frame = 0;
+    size_t m_numEvictions = 0;
+    size_t m_numReloads = 0;
+
+    // Requests of `loadTexture`, indexed by handle.
+    std::vector<LoadRequest> m_loads;
+    ImageDecoder m_decoder;
+    // Images decoded while others are still decoding.
+    std::vector<DecodedImage> m_decodedImages;
+    // Performance counter when the oldest of `m_decodedImages` was collected.
+    uint64_t m_firstDecodedTime = 0;
+    // Decoded images waiting to be packed.
+    std::vector<PendingSurface> m_pendingSurfaces;
+    // Pages packed and waiting for their texture, oldest first.
+    std::vector<size_t> m_uploadQueue;
+    std::unordered_map<std::string, Font> m_fonts;
+    // Fonts whose glyphs wait in `m_pendingSurfaces`.
+    std::vector<std::string> m_pendingFonts;
     // TODO: create collection of audio
 
+    // Runs `task` on the thread owning the device.
+    void withDevice(const std::function<void(RenderDevice&)>& task);
+    // Surface over the packed pixels of an image file, or null.
+    SDL_Surface* getArchivedSurface(const std::string& filePath) const;
+    /**
+     * Moves the decoded images to `m_pendingSurfaces` once all are decoded or
+     * a batch is due, see `DECODED_PACK_BATCH_SIZE`. True if it moved them.
+     */
+    bool collectDecoded();
+    // Packs `m_pendingSurfaces` into pages and queues them for upload.
+    void packPending();
+    // Uploads queued pages until `budgetSeconds` run out, at least one.
+    void uploadPages(double budgetSeconds);
+    // Points the glyphs of the fonts to their regions once uploaded.
+    void resolveFonts();
+    // Marks the loads of an asset that could not be packed as failed.
+    void failLoads(const std::string& assetId);
+
+    void cachePixels(TexturePage& page, SDL_Surface* surface);
+    // Points the assets of the page to its new texture.
+    void finishUpload(TexturePage& page);
+    // Creates the page texture from `surface`.
+    void uploadPage(TexturePage& page, SDL_Surface* surface);
+    void reloadPage(TexturePage& page);
+
   public:
+    // Texture memory, in bytes, kept under by evicting; 0 for no limit.
+    uint64_t textureBudget = 0;
+    // Frames a texture stays unused before it may be evicted.
+    uint32_t evictionFrames = DEFAULT_TEXTURE_EVICTION_FRAMES;
+    /*
+     * Keeps the pixels of the pages run-length encoded in memory, so reloads
+     * skip decoding the image files. Only used with a `textureBudget`, since
+     * nothing is evicted without one, and for pages the encoding shrinks.
+     * Set it before `buildAtlases`.
+     */
+    bool isPixelCacheEnabled = true;
+
     AssetStore();
     ~AssetStore();
 
     void clearAssets();
-    void addTexture(SDL_Renderer* renderer, const std::string& assetId,
-                    const std::string& filePath);
-    SDL_Texture* getTexture(const std::string& assetId) const;
+
+    /**
+     * Reads the images packed in `archive` from its mapped pixels instead of
+     * decoding their files. The archive must outlive the textures.
+     */
+    void setArchive(const AssetArchive* archive) { m_archive = archive; }
+
+    /**
+     * Queues the image for decoding on a worker thread and returns at once;
+     * images of the archive are already decoded and skip the workers.
+     * Once every queued image is decoded, `processLoads` packs them and
+     * creates their textures over the next frames; `getLoadState` tells when
+     * the texture can be drawn. Failures are logged.
+     */
+    AssetHandle loadTexture(const std::string& assetId,
+                            const std::string& filePath);
+
+    // `loadTexture`, for textures needed before `buildAtlases` returns.
+    void addTexture(const std::string& assetId, const std::string& filePath);
+
+    /**
+     * Rasterizes the glyphs of the font at `fontSize` points once and queues
+     * them for packing, like textures. Requires `TTF_Init`. The font can be
+     * drawn once `buildAtlases` runs.
+     */
+    void addFont(const std::string& assetId, const std::string& filePath,
+                 int fontSize);
+
+    /**
+     * Waits for the queued images to decode, then packs them into as few
+     * `ATLAS_PAGE_SIZE` atlas textures as possible and creates them all.
+     * Images that do not fit in a page get a texture of their own. The store
+     * releases the textures through `device` in `clearAssets`.
+     */
+    void buildAtlases(RenderDevice& device);
+
+    /**
+     * Advances the loads of `loadTexture`, once per frame after
+     * `buildAtlases`: packs the decoded images, then creates their textures
+     * for at most `budgetSeconds`, so loading never stalls a frame for long.
+     */
+    void processLoads(double budgetSeconds = DEFAULT_TEXTURE_UPLOAD_BUDGET);
+
+    AssetLoadState getLoadState(AssetHandle handle) const;
+    // Whether textures are still decoding, or waiting to be packed or created.
+    bool isLoading();
+
+    /**
+     * Sends the device work (texture creation and destruction) to the render
+     * thread once it is started, instead of using the device directly.
+     */
+    void setRenderThread(RenderThread* renderThread) {
+      m_renderThread = renderThread;
+    }
+
+    /**
+     * Starts a frame: while the textures are over `textureBudget`, evicts the
+     * least recently used ones not used for `evictionFrames` frames.
+     */
+    void update();
+
+    /**
+     * Region of the asset. Marks its texture as used this frame, and rebuilds
+     * it first if it was evicted (from the pixel cache, or the image files).
+     * The texture is `NULL_TEXTURE` if the device failed to create it.
+     */
+    const TextureRegion& getTexture(const std::string& assetId);
+    /**
+     * Like `getTexture`, but without waiting for loads: null while the asset
+     * is decoding or its page waits in the upload queue, or if it is unknown
+     * or its texture could not be created. Renderers skip what is not ready.
+     */
+    const TextureRegion* findTexture(const std::string& assetId);
+    const Font& getFont(const std::string& assetId) const;
+    // Like `getFont`, but null if the font is unknown, e.g. failed to load.
+    const Font* findFont(const std::string& assetId) const;
+
+    uint64_t getTextureMemory() const { return m_numTextureBytes; }
+    size_t getNumEvictions() const { return m_numEvictions; }
+    size_t getNumReloads() const { return m_numReloads; }
 };
 
-#endif
\ No newline at end of file
+#endif
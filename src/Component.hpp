@@ -1,6 +1,7 @@
 #ifndef COMPONENTS_HPP
 #define COMPONENTS_HPP
 #include <SDL2/SDL.h>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <string>
 
@@ -8,6 +9,12 @@ struct TransformComponent {
     glm::vec2 position;
     glm::vec2 scale;
     float rotation;
+    /*
+     * Position and rotation at the start of the current simulation tick. The
+     * renderer interpolates between them and the current ones.
+     */
+    glm::vec2 previousPosition;
+    float previousRotation;
 
     TransformComponent(glm::vec2 position = glm::vec2(0, 0),
                        glm::vec2 scale = glm::vec2(1, 1),
@@ -15,6 +22,8 @@ struct TransformComponent {
       this->position = position;
       this->scale = scale;
       this->rotation = rotation;
+      this->previousPosition = position;
+      this->previousRotation = rotation;
     }
 };
 
@@ -30,15 +39,126 @@ struct SpriteComponent {
     std::string assetId;
     int width;
     int height;
+    // Render layer, lower layers are drawn first.
+    uint8_t zIndex;
+    /*
+     * Static sprites never move: they are baked into cached chunk textures
+     * and only redrawn when added, removed or patched. Only in layers without
+     * dynamic sprites, which would otherwise always draw in front of them:
+     * elsewhere they are drawn every frame, sorted by depth.
+     */
+    bool isStatic;
     SDL_Rect srcRect;
 
     SpriteComponent(std::string assetId = "", int width = 0, int height = 0,
-                    int srcRectX = 0, int srcRectY = 0) {
+                    int srcRectX = 0, int srcRectY = 0, uint8_t zIndex = 0,
+                    bool isStatic = false) {
       this->assetId = assetId;
       this->width = width;
       this->height = height;
+      this->zIndex = zIndex;
+      this->isStatic = isStatic;
       this->srcRect = {srcRectX, srcRectY, width, height};
     }
 };
 
+/*
+ * Plays a clip of the `AnimationClips` resource on the entity's sprite: the
+ * `AnimationSystem` advances `time` and sets `SpriteComponent::srcRect`.
+ * Animated sprites must not be static. To switch clips, set `clip` and reset
+ * `time` to 0.
+ */
+struct AnimationComponent {
+    uint16_t clip;
+    // Seconds since the clip started, wrapped for looping clips.
+    float time;
+
+    AnimationComponent(uint16_t clip = 0, float time = 0.0) {
+      this->clip = clip;
+      this->time = time;
+    }
+};
+
+/*
+ * Emits particles at the entity's position into the `ParticleSystem` pools.
+ * Particles fly in a straight line and are drawn as `width` x `height` quads
+ * of the asset, fading from `startColor` to `endColor`. They outlive the
+ * emitter. Fields left out of the constructor keep their defaults: particles
+ * go in every direction (`spread` of 360) at `speed`.
+ */
+struct ParticleEmitterComponent {
+    std::string assetId;
+    int width;
+    int height;
+    uint8_t zIndex;
+    SDL_Rect srcRect;
+    // Emission point, relative to the entity position.
+    glm::vec2 offset;
+    // Particles emitted per second.
+    float rate;
+    // Particles emitted at once on the next tick (explosions), then reset.
+    uint32_t burst;
+    // Lifetime and speed of each particle are picked in these ranges.
+    float minLifetime;
+    float maxLifetime;
+    float minSpeed;
+    float maxSpeed;
+    // Degrees clockwise from +x, and width of the emission cone.
+    float direction;
+    float spread;
+    SDL_Color startColor;
+    SDL_Color endColor;
+    // Fraction of a particle left over from the previous ticks.
+    float pendingEmission;
+
+    ParticleEmitterComponent(std::string assetId = "", int width = 0,
+                             int height = 0, uint8_t zIndex = 0,
+                             float rate = 0.0, float lifetime = 1.0,
+                             float speed = 0.0,
+                             SDL_Color startColor = {255, 255, 255, 255},
+                             SDL_Color endColor = {255, 255, 255, 0}) {
+      this->assetId = assetId;
+      this->width = width;
+      this->height = height;
+      this->zIndex = zIndex;
+      this->srcRect = {0, 0, width, height};
+      this->offset = glm::vec2(0, 0);
+      this->rate = rate;
+      this->burst = 0;
+      this->minLifetime = lifetime;
+      this->maxLifetime = lifetime;
+      this->minSpeed = speed;
+      this->maxSpeed = speed;
+      this->direction = 0;
+      this->spread = 360;
+      this->startColor = startColor;
+      this->endColor = endColor;
+      this->pendingEmission = 0;
+    }
+};
+
+/*
+ * Text drawn at the entity's position with a font of the `AssetStore`, by the
+ * `TextRenderSystem`. Fixed labels (HUD) are placed in screen pixels and
+ * ignore the camera; the others follow the world like sprites.
+ */
+struct TextLabelComponent {
+    std::string text;
+    std::string fontId;
+    SDL_Color color;
+    // Render layer, lower layers are drawn first.
+    uint8_t zIndex;
+    bool isFixed;
+
+    TextLabelComponent(std::string text = "", std::string fontId = "",
+                       SDL_Color color = {255, 255, 255, 255},
+                       uint8_t zIndex = 0, bool isFixed = false) {
+      this->text = text;
+      this->fontId = fontId;
+      this->color = color;
+      this->zIndex = zIndex;
+      this->isFixed = isFixed;
+    }
+};
+
 #endif
@@ -0,0 +1,166 @@
+#ifndef COMPONENTINDEX_HPP
+#define COMPONENTINDEX_HPP
+#include "ECS.hpp"
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Extracts the component and key types from a pointer to a component field,
+ * e.g. `&SpriteComponent::assetId`.
+ */
+template <typename T> struct FieldTraits;
+
+template <typename TComponent, typename TKey>
+struct FieldTraits<TKey TComponent::*> {
+    typedef TComponent ComponentType;
+    typedef TKey KeyType;
+};
+
+/**
+ * Ordered secondary index over a component field, backed by a
+ * `std::multimap`. Supports equality and range queries in O(log n + k).
+ *
+ * Usage: `registry.addIndex<SortedIndex<&SpriteComponent::width>>()`.
+ */
+template <auto Field> class SortedIndex : public IComponentIndex {
+  public:
+    typedef typename FieldTraits<decltype(Field)>::ComponentType ComponentType;
+    typedef typename FieldTraits<decltype(Field)>::KeyType KeyType;
+
+  private:
+    typedef std::multimap<KeyType, Entity> Map;
+
+    Map m_entries;
+
+    /*
+     * Position of each entity inside `m_entries`, so it can be erased without
+     * searching. Collection index is the entity ID.
+     */
+    std::vector<typename Map::iterator> m_positions;
+    std::vector<bool> m_isIndexed;
+
+  public:
+    void insert(Entity entity) override {
+      const uint16_t entityId = entity.getId();
+      if (entityId >= m_positions.size()) {
+        m_positions.resize(entityId + 1);
+        m_isIndexed.resize(entityId + 1, false);
+      }
+
+      const KeyType& key = entity.getComponent<ComponentType>().*Field;
+      m_positions[entityId] = m_entries.emplace(key, entity);
+      m_isIndexed[entityId] = true;
+    }
+
+    void erase(Entity entity) override {
+      const uint16_t entityId = entity.getId();
+      if (entityId >= m_isIndexed.size() || !m_isIndexed[entityId]) {
+        return;
+      }
+
+      m_entries.erase(m_positions[entityId]);
+      m_isIndexed[entityId] = false;
+    }
+
+    size_t getSize() const { return m_entries.size(); }
+
+    // Calls `func(entity)` for every entity whose key equals `key`.
+    template <typename TFunc>
+    void forEachEqual(const KeyType& key, TFunc&& func) const {
+      auto range = m_entries.equal_range(key);
+      for (auto entry = range.first; entry != range.second; ++entry) {
+        func(entry->second);
+      }
+    }
+
+    /*
+     * Calls `func(entity)` for every entity whose key is in [min, max), in
+     * ascending key order.
+     */
+    template <typename TFunc>
+    void forEachInRange(const KeyType& min, const KeyType& max,
+                        TFunc&& func) const {
+      auto end = m_entries.lower_bound(max);
+      for (auto entry = m_entries.lower_bound(min); entry != end; ++entry) {
+        func(entry->second);
+      }
+    }
+
+    // Calls `func(entity)` for every entity whose key is lower than `max`.
+    template <typename TFunc>
+    void forEachBelow(const KeyType& max, TFunc&& func) const {
+      auto end = m_entries.lower_bound(max);
+      for (auto entry = m_entries.begin(); entry != end; ++entry) {
+        func(entry->second);
+      }
+    }
+};
+
+/**
+ * Hashed secondary index over a component field, backed by a
+ * `std::unordered_multimap`. Supports equality queries in O(1 + k).
+ *
+ * Usage: `registry.addIndex<HashIndex<&SpriteComponent::assetId>>()`.
+ */
+template <auto Field> class HashIndex : public IComponentIndex {
+  public:
+    typedef typename FieldTraits<decltype(Field)>::ComponentType ComponentType;
+    typedef typename FieldTraits<decltype(Field)>::KeyType KeyType;
+
+  private:
+    std::unordered_multimap<KeyType, Entity> m_entries;
+
+    /*
+     * Key each entity was indexed with. Rehashing invalidates iterators, so
+     * the key is kept to find the entry again. Collection index is the
+     * entity ID.
+     */
+    std::vector<KeyType> m_keys;
+    std::vector<bool> m_isIndexed;
+
+  public:
+    void insert(Entity entity) override {
+      const uint16_t entityId = entity.getId();
+      if (entityId >= m_keys.size()) {
+        m_keys.resize(entityId + 1);
+        m_isIndexed.resize(entityId + 1, false);
+      }
+
+      m_keys[entityId] = entity.getComponent<ComponentType>().*Field;
+      m_entries.emplace(m_keys[entityId], entity);
+      m_isIndexed[entityId] = true;
+    }
+
+    void erase(Entity entity) override {
+      const uint16_t entityId = entity.getId();
+      if (entityId >= m_isIndexed.size() || !m_isIndexed[entityId]) {
+        return;
+      }
+
+      auto range = m_entries.equal_range(m_keys[entityId]);
+      for (auto entry = range.first; entry != range.second; ++entry) {
+        if (entry->second.getId() == entityId) {
+          m_entries.erase(entry);
+          break;
+        }
+      }
+      m_isIndexed[entityId] = false;
+    }
+
+    size_t getSize() const { return m_entries.size(); }
+
+    size_t count(const KeyType& key) const { return m_entries.count(key); }
+
+    // Calls `func(entity)` for every entity whose key equals `key`.
+    template <typename TFunc>
+    void forEachEqual(const KeyType& key, TFunc&& func) const {
+      auto range = m_entries.equal_range(key);
+      for (auto entry = range.first; entry != range.second; ++entry) {
+        func(entry->second);
+      }
+    }
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include "spdlog/spdlog.h"
 
 uint8_t IComponent::nextId = 0;
+uint8_t IResource::nextId = 0;
 
 // -------- Entity implementation ------------
 
@@ -31,6 +32,22 @@ const std::vector<Entity>& System::getEntities() const { return m_entities; }
 
 const Signature& System::getSignature() const { return m_signature; }
 
+const ResourceSignature& System::getReadResources() const {
+  return m_readResources;
+}
+
+const ResourceSignature& System::getWriteResources() const {
+  return m_writeResources;
+}
+
+bool System::hasResourceConflict(const System& other) const {
+  const auto otherAccess = other.m_readResources | other.m_writeResources;
+  const auto access = m_readResources | m_writeResources;
+
+  return (m_writeResources & otherAccess).any() ||
+         (other.m_writeResources & access).any();
+}
+
 // --------- Registry implementation -----------
 
 Entity Registry::createEntity() {
@@ -43,7 +60,7 @@ Entity Registry::createEntity() {
     m_entityComponentSignatures.resize(entityId + 1);
   }
 
-  spdlog::info("[Registry] Entity created with id = {}.", entityId);
+  LOG_TRACE("[Registry] Entity created with id = {}.", entityId);
   return entity;
 }
 
@@ -61,6 +78,26 @@ void Registry::addEntityToSystems(Entity entity) {
   }
 }
 
+void Registry::insertIntoIndexes(uint8_t componentId, Entity entity) {
+  if (componentId >= m_componentIndexes.size()) {
+    return;
+  }
+  entity.registry = this;
+  for (auto& index : m_componentIndexes[componentId]) {
+    index->insert(entity);
+  }
+}
+
+void Registry::eraseFromIndexes(uint8_t componentId, Entity entity) {
+  if (componentId >= m_componentIndexes.size()) {
+    return;
+  }
+  entity.registry = this;
+  for (auto& index : m_componentIndexes[componentId]) {
+    index->erase(entity);
+  }
+}
+
 void Registry::update() {
   for (auto entity : m_entitiesToBeAdded) {
     addEntityToSystems(entity);
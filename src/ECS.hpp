@@ -1,6 +1,7 @@
 #ifndef ECS_H
 #define ECS_H
 #include "spdlog/spdlog.h"
+#include "utils/Log.hpp"
 #include <bitset>
 #include <cstdint>
 #include <memory>
@@ -23,6 +24,17 @@ const uint8_t MAX_COMPONENTS = 32;
  */
 typedef std::bitset<MAX_COMPONENTS> Signature;
 
+/**
+ * Upper limit for the number of resource types (singleton components) the
+ * registry can hold.
+ */
+const uint8_t MAX_RESOURCES = 32;
+
+/*
+ * Bitset to represent which resources a system reads or writes.
+ */
+typedef std::bitset<MAX_RESOURCES> ResourceSignature;
+
 // ------------ Entity ---------------------------------------------------------
 
 class Entity {
@@ -46,6 +58,8 @@ class Entity {
     template <typename TComponent> void removeComponent();
     template <typename TComponent> bool hasComponent() const;
     template <typename TComponent> TComponent& getComponent() const;
+    template <typename TComponent, typename TFunc>
+    void patchComponent(TFunc&& func);
 };
 
 // ----------- Component ----------------
@@ -73,6 +87,26 @@ template <typename TComponent> class Component : public IComponent {
     }
 };
 
+// ----------- Resource ----------------
+
+/*
+ * Interface for all resources, the singleton components stored once in the
+ * registry instead of per entity (camera, frame time, map dimensions...). It
+ * provides the static counter used to generate unique IDs per resource type.
+ */
+struct IResource {
+  protected:
+    static uint8_t nextId;
+};
+
+template <typename TResource> class Resource : public IResource {
+  public:
+    static uint8_t getId() {
+      static auto id = nextId++;
+      return id;
+    }
+};
+
 // --------------- System ---------------
 
 class System {
@@ -91,7 +125,14 @@ class System {
      */
     std::vector<Entity> m_entities;
 
+    // Resources the system reads and writes during its update.
+    ResourceSignature m_readResources;
+    ResourceSignature m_writeResources;
+
   public:
+    // System's owner, set by `Registry::addSystem`.
+    class Registry* registry = nullptr;
+
     System() = default;
     ~System() = default;
 
@@ -119,6 +160,19 @@ class System {
      * have the required component.
      */
     template <typename T> void requireComponent();
+
+    /*
+     * Declares that the system reads or writes the resource T. A scheduler can
+     * run two systems concurrently only if their declarations do not conflict.
+     */
+    template <typename T> void readResource();
+    template <typename T> void writeResource();
+
+    const ResourceSignature& getReadResources() const;
+    const ResourceSignature& getWriteResources() const;
+
+    // True if one of the systems writes a resource the other reads or writes.
+    bool hasResourceConflict(const System& other) const;
 };
 
 // -------------- Registry ---------------------
@@ -150,6 +204,40 @@ template <typename T> class Pool : public IPool {
     void set(uint16_t index, T object) { m_data[index] = object; };
     T& get(uint16_t index) { return m_data[index]; }
     T& operator[](uint16_t index) { return m_data[index]; }
+    T* getData() { return m_data.data(); }
+};
+
+/**
+ * Interface for a secondary index over a component field. The registry keeps
+ * every index of a component type up to date when a component is added,
+ * removed or modified through `Registry::patchComponent`. Concrete indexes live
+ * in `ComponentIndex.hpp`.
+ */
+class IComponentIndex {
+  public:
+    virtual ~IComponentIndex() {}
+    // Called after the component of the entity has been set.
+    virtual void insert(Entity entity) = 0;
+    // Called before the component of the entity is changed or removed.
+    virtual void erase(Entity entity) = 0;
+};
+
+/**
+ * Interface for a resource holder, providing a virtual destructor.
+ */
+class IResourceHolder {
+  public:
+    virtual ~IResourceHolder() {}
+};
+
+// Holds the single instance of a resource of type T
+template <typename T> class ResourceHolder : public IResourceHolder {
+  public:
+    T value;
+
+    template <typename... TArgs>
+    ResourceHolder(TArgs&&... args) : value(std::forward<TArgs>(args)...) {}
+    virtual ~ResourceHolder() = default;
 };
 
 class Registry {
@@ -181,6 +269,28 @@ class Registry {
      */
     std::unordered_map<std::type_index, std::shared_ptr<System>> m_systems;
 
+    /*
+     * Secondary indexes of each component type. Collection index is the
+     * component ID.
+     */
+    std::vector<std::vector<std::shared_ptr<IComponentIndex>>>
+        m_componentIndexes;
+
+    /*
+     * Map of secondary indexes. Index is the component index `std::type_index`.
+     */
+    std::unordered_map<std::type_index, std::shared_ptr<IComponentIndex>>
+        m_indexes;
+
+    /**
+     * Collection of resources, stored outside the per-entity pools.
+     * Collection index is the resource ID.
+     */
+    std::vector<std::shared_ptr<IResourceHolder>> m_resources;
+
+    void insertIntoIndexes(uint8_t componentId, Entity entity);
+    void eraseFromIndexes(uint8_t componentId, Entity entity);
+
   public:
     Registry() { spdlog::info("[Registry] created."); }
     ~Registry() { spdlog::info("[Registry] destroyed."); }
@@ -206,6 +316,46 @@ class Registry {
     template <typename TComponent>
     TComponent& getComponent(Entity entity) const;
 
+    /**
+     * Modifies the component of an entity through `func(TComponent&)` and
+     * refreshes the secondary indexes of that component type. Changes made
+     * through `getComponent` are not seen by the indexes. Does nothing if
+     * the entity lacks the component.
+     */
+    template <typename TComponent, typename TFunc>
+    void patchComponent(Entity entity, TFunc&& func);
+
+    /**
+     * Pool of the components of type TComponent, indexed by entity ID, for
+     * systems that loop over many entities without a lookup per component.
+     * The pool must exist (some entity got the component) and its storage
+     * moves when entities are added. Writes through the pool bypass the
+     * secondary indexes of the component, like those through `getComponent`;
+     * use `patchComponent` for the indexed fields.
+     */
+    template <typename TComponent> Pool<TComponent>& getPool() const;
+
+    /**
+     * Creates a secondary index of type TIndex (see `ComponentIndex.hpp`),
+     * forwarding the provided arguments to its constructor, and fills it with
+     * the entities that already hold the indexed component. If an index of
+     * that type exists already, it is returned and the arguments are ignored.
+     */
+    template <typename TIndex, typename... TArgs>
+    TIndex& addIndex(TArgs&&... args);
+    template <typename TIndex> bool hasIndex() const;
+    template <typename TIndex> TIndex& getIndex() const;
+
+    /**
+     * Creates (or replaces) the resource of type TResource, forwarding the
+     * provided arguments to its constructor. Access is O(1) by resource ID.
+     */
+    template <typename TResource, typename... TArgs>
+    TResource& setResource(TArgs&&... args);
+    template <typename TResource> void removeResource();
+    template <typename TResource> bool hasResource() const;
+    template <typename TResource> TResource& getResource() const;
+
     template <typename TSystem, typename... TArgs>
     void addSystem(TArgs&&... args);
     template <typename TSystem> void removeSystem();
@@ -237,6 +387,11 @@ template <typename TComponent> TComponent& Entity::getComponent() const {
   return this->registry->getComponent<TComponent>(*this);
 }
 
+template <typename TComponent, typename TFunc>
+void Entity::patchComponent(TFunc&& func) {
+  this->registry->patchComponent<TComponent>(*this, std::forward<TFunc>(func));
+}
+
 template <typename TComponent, typename... TArgs>
 void Registry::addComponent(Entity entity, TArgs&&... args) {
   const uint8_t componentId = Component<TComponent>::getId();
@@ -267,23 +422,32 @@ void Registry::addComponent(Entity entity, TArgs&&... args) {
   // parameters to the constructor
   TComponent newComponent(std::forward<TArgs>(args)...);
 
+  // the entity already had this component: drop its old index entries
+  if (m_entityComponentSignatures[entityId].test(componentId)) {
+    eraseFromIndexes(componentId, entity);
+  }
+
   // add the new component to the component pool list, using the entityId as
   // index
   componentPool->set(entityId, newComponent);
 
   // finally, change the component signature of the entity.
   m_entityComponentSignatures[entityId].set(componentId);
-  spdlog::info("[Registry] componentId=" + std::to_string(componentId) +
-               " added to entityId= " + std::to_string(componentId));
+  insertIntoIndexes(componentId, entity);
+  LOG_TRACE("[Registry] componentId={} added to entityId={}", componentId,
+            entityId);
 }
 
 template <typename TComponent> void Registry::removeComponent(Entity entity) {
   const uint8_t componentId = Component<TComponent>::getId();
   const uint16_t entityId = entity.getId();
 
+  if (m_entityComponentSignatures[entityId].test(componentId)) {
+    eraseFromIndexes(componentId, entity);
+  }
   m_entityComponentSignatures[entityId].set(componentId, false);
-  spdlog::info("[Registry] componentId=" + std::to_string(componentId) +
-               " was removed from entityId=" + std::to_string(entityId));
+  LOG_TRACE("[Registry] componentId={} was removed from entityId={}",
+            componentId, entityId);
 }
 
 template <typename TComponent>
@@ -304,15 +468,119 @@ TComponent& Registry::getComponent(Entity entity) const {
   return componentPool->get(entityId);
 }
 
+template <typename TComponent>
+Pool<TComponent>& Registry::getPool() const {
+  const uint8_t componentId = Component<TComponent>::getId();
+  return *static_cast<Pool<TComponent>*>(m_componentPools[componentId].get());
+}
+
+template <typename TComponent, typename TFunc>
+void Registry::patchComponent(Entity entity, TFunc&& func) {
+  const uint8_t componentId = Component<TComponent>::getId();
+  if (!hasComponent<TComponent>(entity)) {
+    spdlog::error("[Registry] Entity {} has no component {} to patch",
+                  entity.getId(), componentId);
+    return;
+  }
+
+  eraseFromIndexes(componentId, entity);
+  func(getComponent<TComponent>(entity));
+  insertIntoIndexes(componentId, entity);
+}
+
+template <typename TIndex, typename... TArgs>
+TIndex& Registry::addIndex(TArgs&&... args) {
+  typedef typename TIndex::ComponentType TComponent;
+  const uint8_t componentId = Component<TComponent>::getId();
+  if (hasIndex<TIndex>()) {
+    return getIndex<TIndex>();
+  }
+
+  std::shared_ptr<TIndex> newIndex =
+      std::make_shared<TIndex>(std::forward<TArgs>(args)...);
+  m_indexes.insert(std::make_pair(std::type_index(typeid(TIndex)), newIndex));
+  if (componentId >= m_componentIndexes.size()) {
+    m_componentIndexes.resize(componentId + 1);
+  }
+  m_componentIndexes[componentId].push_back(newIndex);
+
+  // index the entities that already hold the component
+  for (uint16_t entityId = 0; entityId < m_entityComponentSignatures.size();
+       entityId++) {
+    if (m_entityComponentSignatures[entityId].test(componentId)) {
+      Entity entity(entityId);
+      entity.registry = this;
+      newIndex->insert(entity);
+    }
+  }
+
+  return *newIndex;
+}
+
+template <typename TIndex> bool Registry::hasIndex() const {
+  return m_indexes.find(std::type_index(typeid(TIndex))) != m_indexes.end();
+}
+
+template <typename TIndex> TIndex& Registry::getIndex() const {
+  auto index = m_indexes.find(std::type_index(typeid(TIndex)));
+  return *(std::static_pointer_cast<TIndex>(index->second));
+}
+
 template <typename TComponent> void System::requireComponent() {
   const auto componentId = Component<TComponent>::getId();
   m_signature.set(componentId);
 }
 
+template <typename T> void System::readResource() {
+  m_readResources.set(Resource<T>::getId());
+}
+
+template <typename T> void System::writeResource() {
+  m_writeResources.set(Resource<T>::getId());
+}
+
+template <typename TResource, typename... TArgs>
+TResource& Registry::setResource(TArgs&&... args) {
+  const uint8_t resourceId = Resource<TResource>::getId();
+
+  if (resourceId >= m_resources.size()) {
+    m_resources.resize(resourceId + 1, nullptr);
+  }
+
+  std::shared_ptr<ResourceHolder<TResource>> holder =
+      std::make_shared<ResourceHolder<TResource>>(std::forward<TArgs>(args)...);
+  m_resources[resourceId] = holder;
+
+  return holder->value;
+}
+
+template <typename TResource> void Registry::removeResource() {
+  const uint8_t resourceId = Resource<TResource>::getId();
+
+  if (resourceId < m_resources.size()) {
+    m_resources[resourceId] = nullptr;
+  }
+}
+
+template <typename TResource> bool Registry::hasResource() const {
+  const uint8_t resourceId = Resource<TResource>::getId();
+
+  return resourceId < m_resources.size() && m_resources[resourceId];
+}
+
+template <typename TResource> TResource& Registry::getResource() const {
+  const uint8_t resourceId = Resource<TResource>::getId();
+  auto holder = static_cast<ResourceHolder<TResource>*>(
+      m_resources[resourceId].get());
+
+  return holder->value;
+}
+
 template <typename TSystem, typename... TArgs>
 void Registry::addSystem(TArgs&&... args) {
   std::shared_ptr<TSystem> newSystem =
       std::make_shared<TSystem>(std::forward<TArgs>(args)...);
+  newSystem->registry = this;
   m_systems.insert(std::make_pair(std::type_index(typeid(TSystem)), newSystem));
 }
 
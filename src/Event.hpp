@@ -0,0 +1,19 @@
+#ifndef EVENT_HPP
+#define EVENT_HPP
+#include <SDL2/SDL.h>
+
+struct QuitEvent {};
+
+struct KeyPressedEvent {
+    SDL_Keycode key;
+
+    KeyPressedEvent(SDL_Keycode key = 0) { this->key = key; }
+};
+
+struct KeyReleasedEvent {
+    SDL_Keycode key;
+
+    KeyReleasedEvent(SDL_Keycode key = 0) { this->key = key; }
+};
+
+#endif
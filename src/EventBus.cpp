@@ -0,0 +1,21 @@
+#include "EventBus.hpp"
+
+uint8_t IEvent::nextId = 0;
+
+void EventBus::dispatch() {
+  // handlers may create queues of new event types: re-read the size
+  for (size_t i = 0; i < m_queues.size(); i++) {
+    IEventQueue* queue = m_queues[i].get();
+    if (queue) {
+      queue->dispatch();
+    }
+  }
+}
+
+void EventBus::clear() {
+  for (auto& queue : m_queues) {
+    if (queue) {
+      queue->clear();
+    }
+  }
+}
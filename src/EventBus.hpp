@@ -0,0 +1,248 @@
+#ifndef EVENTBUS_HPP
+#define EVENTBUS_HPP
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// ----------- Event ----------------
+
+/*
+ * Interface for all event types. It provides the static counter used to
+ * generate a unique ID per event type, which indexes the bus queues.
+ */
+struct IEvent {
+  protected:
+    static uint8_t nextId;
+};
+
+template <typename TEvent> class Event : public IEvent {
+  public:
+    static uint8_t getId() {
+      static auto id = nextId++;
+      return id;
+    }
+};
+
+/*
+ * Extracts the owner and event types from an event handler method pointer,
+ * e.g. `&Game::onKeyPressed`.
+ */
+template <typename T> struct EventHandlerTraits;
+
+template <typename TOwner, typename TEvent>
+struct EventHandlerTraits<void (TOwner::*)(const TEvent&)> {
+    typedef TOwner OwnerType;
+    typedef TEvent EventType;
+};
+
+// ----------- EventQueue ----------------
+
+/**
+ * Interface for a queue of events, providing a virtual destructor and the
+ * type-independent operations used by `EventBus::dispatch()`.
+ */
+class IEventQueue {
+  public:
+    virtual ~IEventQueue() {}
+    virtual void dispatch() = 0;
+    virtual void clear() = 0;
+};
+
+/**
+ * Contiguous queue of events of type TEvent and its subscribers. Handlers are
+ * plain function pointers that receive a whole batch of events, so there is one
+ * indirect call per subscriber per batch and no `std::function`. The queue
+ * vectors keep their capacity, so steady-state dispatch does not allocate.
+ */
+template <typename TEvent> class EventQueue : public IEventQueue {
+  private:
+    struct Handler {
+        void* owner;
+        void (*callback)(void* owner, const TEvent* events, size_t count);
+    };
+
+    std::vector<Handler> m_handlers;
+    /*
+     * Handlers subscribed while events are delivered, added once the
+     * delivery ends. Unsubscribed handlers get a null owner until then.
+     */
+    std::vector<Handler> m_subscribing;
+    bool m_hasUnsubscribed = false;
+    // Deliveries in progress, more than one when handlers emit.
+    uint32_t m_numDelivering = 0;
+
+    // Events waiting for the next `dispatch()`.
+    std::vector<TEvent> m_pending;
+
+    /*
+     * Batch being delivered. Events enqueued by handlers during a dispatch go
+     * to `m_pending` and are delivered by the next one.
+     */
+    std::vector<TEvent> m_dispatching;
+
+    template <auto Method>
+    static void invoke(void* owner, const TEvent* events, size_t count) {
+      auto* typedOwner =
+          static_cast<typename EventHandlerTraits<decltype(Method)>::OwnerType*>(
+              owner);
+      for (size_t i = 0; i < count; i++) {
+        (typedOwner->*Method)(events[i]);
+      }
+    }
+
+    void deliver(const TEvent* events, size_t count) {
+      m_numDelivering++;
+      for (size_t i = 0; i < m_handlers.size(); i++) {
+        const Handler handler = m_handlers[i];
+        if (handler.owner) {
+          handler.callback(handler.owner, events, count);
+        }
+      }
+      if (--m_numDelivering > 0) {
+        return;
+      }
+
+      if (m_hasUnsubscribed) {
+        eraseHandlers(m_handlers, nullptr);
+        m_hasUnsubscribed = false;
+      }
+      m_handlers.insert(m_handlers.end(), m_subscribing.begin(),
+                        m_subscribing.end());
+      m_subscribing.clear();
+    }
+
+    static void eraseHandlers(std::vector<Handler>& handlers,
+                              const void* owner) {
+      for (auto handler = handlers.begin(); handler != handlers.end();) {
+        if (handler->owner == owner) {
+          handler = handlers.erase(handler);
+        } else {
+          ++handler;
+        }
+      }
+    }
+
+  public:
+    virtual ~EventQueue() = default;
+
+    template <auto Method>
+    void subscribe(typename EventHandlerTraits<decltype(Method)>::OwnerType*
+                       owner) {
+      const Handler handler = {owner, &EventQueue::invoke<Method>};
+      if (m_numDelivering > 0) {
+        m_subscribing.push_back(handler);
+      } else {
+        m_handlers.push_back(handler);
+      }
+    }
+
+    /*
+     * Removes every handler registered by `owner`. During a delivery, they
+     * are skipped right away and removed once it ends.
+     */
+    void unsubscribe(const void* owner) {
+      eraseHandlers(m_subscribing, owner);
+      if (m_numDelivering == 0) {
+        eraseHandlers(m_handlers, owner);
+        return;
+      }
+      for (auto& handler : m_handlers) {
+        if (handler.owner == owner) {
+          handler.owner = nullptr;
+          m_hasUnsubscribed = true;
+        }
+      }
+    }
+
+    // Delivers the event to every subscriber right away.
+    void emit(const TEvent& event) { deliver(&event, 1); }
+
+    // Stores the event until the next `dispatch()`.
+    template <typename... TArgs> void enqueue(TArgs&&... args) {
+      m_pending.emplace_back(std::forward<TArgs>(args)...);
+    }
+
+    size_t getNumPending() const { return m_pending.size(); }
+
+    /*
+     * Delivers the pending events. Called from a handler of this type, it
+     * does nothing: the batch being delivered would be overwritten, so the
+     * events wait for the next `dispatch()` instead.
+     */
+    void dispatch() override {
+      if (m_pending.empty() || m_numDelivering > 0) {
+        return;
+      }
+      std::swap(m_pending, m_dispatching);
+      deliver(m_dispatching.data(), m_dispatching.size());
+      m_dispatching.clear();
+    }
+
+    void clear() override { m_pending.clear(); }
+};
+
+// ----------- EventBus ----------------
+
+/**
+ * Typed publish/subscribe bus. Events are either delivered immediately with
+ * `emit` or pushed into a per-type queue with `enqueue` and delivered in
+ * batches when `dispatch` is called at a defined point of the frame.
+ *
+ * Handlers are methods with the signature `void onEvent(const TEvent&)`:
+ *   eventBus.subscribe<&Game::onKeyPressed>(this);
+ */
+class EventBus {
+  private:
+    /*
+     * Collection of event queues. Collection index is the event ID.
+     */
+    std::vector<std::unique_ptr<IEventQueue>> m_queues;
+
+    template <typename TEvent> EventQueue<TEvent>& getQueue() {
+      const uint8_t eventId = Event<TEvent>::getId();
+
+      if (eventId >= m_queues.size()) {
+        m_queues.resize(eventId + 1);
+      }
+      if (!m_queues[eventId]) {
+        m_queues[eventId] = std::make_unique<EventQueue<TEvent>>();
+      }
+
+      return *static_cast<EventQueue<TEvent>*>(m_queues[eventId].get());
+    }
+
+  public:
+    template <auto Method>
+    void subscribe(typename EventHandlerTraits<decltype(Method)>::OwnerType*
+                       owner) {
+      typedef typename EventHandlerTraits<decltype(Method)>::EventType TEvent;
+      getQueue<TEvent>().template subscribe<Method>(owner);
+    }
+
+    template <typename TEvent> void unsubscribe(const void* owner) {
+      getQueue<TEvent>().unsubscribe(owner);
+    }
+
+    // Immediate delivery: handlers run before `emit` returns.
+    template <typename TEvent, typename... TArgs> void emit(TArgs&&... args) {
+      getQueue<TEvent>().emit(TEvent(std::forward<TArgs>(args)...));
+    }
+
+    // Deferred delivery: handlers run on the next `dispatch`.
+    template <typename TEvent, typename... TArgs> void enqueue(TArgs&&... args) {
+      getQueue<TEvent>().enqueue(std::forward<TArgs>(args)...);
+    }
+
+    // Delivers the pending events of type TEvent.
+    template <typename TEvent> void dispatch() { getQueue<TEvent>().dispatch(); }
+
+    // Delivers the pending events of every type, in event ID order.
+    void dispatch();
+
+    // Drops the pending events of every type without delivering them.
+    void clear();
+};
+
+#endif
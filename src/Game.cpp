@@ -1,36 +1,99 @@
 #include "Game.hpp"
+#include "AnimationClips.hpp"
 #include "Component.hpp"
 #include "ECS.hpp"
+#include "Event.hpp"
+#include "Resource.hpp"
+#include "Tilemap.hpp"
+#include "render/SdlRenderDevice.hpp"
 #include "SDL2/SDL_events.h"
 #include "SDL2/SDL_render.h"
 #include "SDL2/SDL_timer.h"
 #include "glm/ext/vector_float2.hpp"
 #include "spdlog/spdlog.h"
+#include "systems/AnimationSystem.hpp"
 #include "systems/MovementSystem.hpp"
+#include "systems/ParticleSystem.hpp"
 #include "systems/RenderSystem.hpp"
+#include "systems/TextRenderSystem.hpp"
+#include "systems/TransformHistorySystem.hpp"
+#include "utils/Log.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
-#include <fstream>
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
 
 Game::Game() {
+  initializeLogLevel();
   m_isRunning = false;
   m_previousFrameTime = 0;
+  m_accumulator = 0;
+  m_window = nullptr;
+  m_renderer = nullptr;
+  m_softwareDevice = nullptr;
+  m_isWindowHidden = false;
+  m_isRedrawNeeded = false;
+  m_displayFrameRate = DEFAULT_DISPLAY_FRAME_RATE;
   m_registry = std::make_unique<Registry>();
   m_assetStore = std::make_unique<AssetStore>();
+  m_eventBus = std::make_unique<EventBus>();
+  m_renderThread = std::make_unique<RenderThread>();
+  m_eventBus->subscribe<&Game::onQuit>(this);
+  m_eventBus->subscribe<&Game::onKeyPressed>(this);
   spdlog::info("[Game] created.");
 }
 
 Game::~Game() { spdlog::info("[Game] destroyed."); }
 
 void Game::initialize() {
+  if (isHeadless) {
+    // no video: only the timer and the event queue (quit on SIGINT/SIGTERM)
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+      spdlog::error("Error initializing SDL: {}", SDL_GetError());
+      return;
+    }
+    windowWidth = 800;
+    windowHeight = 600;
+    if (headlessRenderDevice != HEADLESS_RENDER_NONE) {
+      if (TTF_Init() != 0) {
+        spdlog::error("Error initializing SDL_ttf: {}", TTF_GetError());
+        return;
+      }
+      if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) == 0) {
+        spdlog::error("Error initializing SDL_image: {}", IMG_GetError());
+        return;
+      }
+    }
+    if (headlessRenderDevice == HEADLESS_RENDER_NULL) {
+      setBackendDevice(std::make_unique<NullRenderDevice>());
+    } else if (headlessRenderDevice == HEADLESS_RENDER_SOFTWARE) {
+      auto softwareDevice =
+          std::make_unique<SoftwareRenderDevice>(windowWidth, windowHeight);
+      m_softwareDevice = softwareDevice.get();
+      setBackendDevice(std::move(softwareDevice));
+    }
+    m_isRunning = true;
+    return;
+  }
+
   if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
     spdlog::error("Error initializing SDL: {}", SDL_GetError());
     return;
   }
+  if (TTF_Init() != 0) {
+    spdlog::error("Error initializing SDL_ttf: {}", TTF_GetError());
+    return;
+  }
+  // up front: the asset decoder threads must not initialize it concurrently
+  if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) == 0) {
+    spdlog::error("Error initializing SDL_image: {}", IMG_GetError());
+    return;
+  }
 
   windowWidth = 800;
   windowHeight = 600;
@@ -42,97 +105,224 @@ void Game::initialize() {
     return;
   }
 
+  SDL_DisplayMode displayMode;
+  if (SDL_GetWindowDisplayMode(m_window, &displayMode) == 0 &&
+      displayMode.refresh_rate > 0) {
+    m_displayFrameRate = static_cast<uint16_t>(displayMode.refresh_rate);
+  }
+
   m_renderer = SDL_CreateRenderer(
       m_window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
   if (!m_renderer) {
     spdlog::error("Error creating SDL renderer: {}", SDL_GetError());
     return;
   }
+  setBackendDevice(std::make_unique<SdlRenderDevice>(m_renderer));
 
   m_isRunning = true;
 }
 
+void Game::setBackendDevice(std::unique_ptr<RenderDevice> device) {
+  m_backendDevice = std::move(device);
+  m_renderDevice =
+      std::make_unique<CountingRenderDevice>(m_backendDevice.get());
+  m_renderThread->setDevice(m_renderDevice.get());
+  m_assetStore->setRenderThread(m_renderThread.get());
+}
+
 void Game::loadLevel(uint8_t level) {
+  m_registry->addSystem<TransformHistorySystem>();
   m_registry->addSystem<MovementSystem>();
+  m_registry->addSystem<AnimationSystem>();
+  m_registry->addSystem<ParticleSystem>();
   m_registry->addSystem<RenderSystem>();
+  m_registry->addSystem<TextRenderSystem>();
+  m_registry->getSystem<RenderSystem>().trackStaticSprites();
+  m_registry->setResource<FrameTimeResource>();
+  m_registry->setResource<CameraResource>(
+      glm::vec2(0, 0), 1.0, SDL_Rect{0, 0, windowWidth, windowHeight});
 
   // adding assets to the AssetStore
-  m_assetStore->addTexture(m_renderer, "tank-image",
-                           "../assets/images/tank-panther-right.png");
-  m_assetStore->addTexture(m_renderer, "truck-image",
-                           "../assets/images/truck-ford-right.png");
+  m_assetStore->textureBudget = textureBudget;
+  if (!assetArchivePath.empty() && m_assetArchive.open(assetArchivePath)) {
+    m_assetStore->setArchive(&m_assetArchive);
+  }
+  if (m_renderDevice) {
+    m_assetStore->addTexture("tank-image",
+                             "../assets/images/tank-panther-right.png");
+    m_assetStore->addTexture("truck-image",
+                             "../assets/images/truck-ford-right.png");
+    m_assetStore->addTexture("chopper-image",
+                             "../assets/images/chopper-spritesheet.png");
+    m_assetStore->addTexture("bullet-image", "../assets/images/bullet.png");
+    m_assetStore->addFont("charriot-font", "../assets/fonts/charriot.ttf", 20);
+  }
+
+  // the chopper sheet has one row of 2 frames per direction
+  auto& clips = m_registry->setResource<AnimationClips>();
+  const char* chopperClips[] = {"chopper-up", "chopper-right", "chopper-down",
+                                "chopper-left"};
+  for (int row = 0; row < 4; row++) {
+    clips.addSheetClip(chopperClips[row], SDL_Rect{0, row * 32, 32, 32}, 2,
+                       15.0, ANIMATION_LOOP);
+  }
 
   loadTilemap("./assets/tilemaps/jungle.map", "../assets/tilemaps/jungle.png",
               32, 1.5);
 
+  // the images decoded on worker threads meanwhile: pack them into atlases
+  if (m_renderDevice) {
+    m_assetStore->buildAtlases(*m_renderDevice);
+  }
+
   Entity tank = m_registry->createEntity();
   tank.addComponent<TransformComponent>(glm::vec2(10.0, 30.0),
                                         glm::vec2(1.0, 1.0), 45.0);
   tank.addComponent<RigidBodyComponent>(glm::vec2(50.0, 0.0));
-  tank.addComponent<SpriteComponent>("tank-image", 32, 32);
+  tank.addComponent<SpriteComponent>("tank-image", 32, 32, 0, 0, 1);
+  // exhaust smoke, fading out behind the tank
+  tank.addComponent<ParticleEmitterComponent>(
+      "bullet-image", 4, 4, 1, 60.0, 1.0, 20.0, SDL_Color{160, 160, 160, 200},
+      SDL_Color{80, 80, 80, 0});
+  auto& exhaust = tank.getComponent<ParticleEmitterComponent>();
+  exhaust.offset = glm::vec2(0.0, 16.0);
+  exhaust.direction = 180.0;
+  exhaust.spread = 40.0;
+  exhaust.minLifetime = 0.5;
+  exhaust.minSpeed = 10.0;
 
   Entity truck = m_registry->createEntity();
   truck.addComponent<TransformComponent>(glm::vec2(50.0, 100.0),
                                          glm::vec2(1.0, 1.0), 0.0);
   truck.addComponent<RigidBodyComponent>(glm::vec2(0.0, 50.0));
-  truck.addComponent<SpriteComponent>("truck-image", 32, 32);
+  truck.addComponent<SpriteComponent>("truck-image", 32, 32, 0, 0, 1);
+
+  Entity chopper = m_registry->createEntity();
+  chopper.addComponent<TransformComponent>(glm::vec2(10.0, 200.0),
+                                           glm::vec2(1.0, 1.0), 0.0);
+  chopper.addComponent<RigidBodyComponent>(glm::vec2(40.0, 0.0));
+  chopper.addComponent<SpriteComponent>("chopper-image", 32, 32, 0, 0, 2);
+  chopper.addComponent<AnimationComponent>(clips.getClipId("chopper-right"));
+
+  Entity title = m_registry->createEntity();
+  title.addComponent<TransformComponent>(glm::vec2(10.0, 10.0));
+  title.addComponent<TextLabelComponent>("flatland", "charriot-font",
+                                         SDL_Color{255, 255, 255, 255}, 3,
+                                         true);
 }
 
 void Game::setup() { loadLevel(1); }
 
 void Game::run() {
   setup();
+  if (isHeadless) {
+    runHeadless();
+    return;
+  }
+  // statistics of the frames only, not of the loading; no device if
+  // `initialize` failed
+  if (m_renderDevice) {
+    m_renderThread->setCounters(&m_renderDevice->getCounters());
+  }
+  if (isRenderThreaded) {
+    m_renderThread->start();
+  }
+  m_previousFrameTime = SDL_GetPerformanceCounter();
   while (m_isRunning) {
+    const uint64_t frameStart = SDL_GetPerformanceCounter();
     processInput();
     update();
+    if (m_isWindowHidden) {
+      // nobody sees the frames: skip the extract stage as well
+      waitForFrameEnd(frameStart, hiddenFrameRate);
+      continue;
+    }
     render();
+    if (m_renderThread->isIdle()) {
+      // no present, so no vsync wait to throttle the loop
+      waitForFrameEnd(frameStart, m_displayFrameRate);
+    }
   }
+  m_renderThread->stop();
 }
 
-void Game::loadTilemap(std::string mapFilePath, std::string spriteFilePath,
-                       uint32_t tileSize, float scale) {
-  std::fstream mapFile;
-  std::filesystem::path filePath(mapFilePath);
-  if (!std::filesystem::exists(filePath)) {
-    spdlog::error("Map file does not exist: {}", mapFilePath);
-    return;
+void Game::waitForFrameEnd(uint64_t frameStart, uint16_t frameRate) {
+  const uint64_t frequency = SDL_GetPerformanceFrequency();
+  const uint64_t frameEnd =
+      frameStart + frequency / std::max<uint16_t>(frameRate, 1);
+  const uint64_t now = SDL_GetPerformanceCounter();
+  if (now < frameEnd) {
+    SDL_Delay(static_cast<uint32_t>((frameEnd - now) * 1000 / frequency));
   }
+}
 
-  m_assetStore->addTexture(m_renderer, "tilemap-image", spriteFilePath);
-  mapFile.open(mapFilePath);
-  if (!mapFile.is_open()) {
-    spdlog::error("Failed to open map file: {}", mapFilePath);
-    return;
+void Game::runHeadless() {
+  const uint64_t frequency = SDL_GetPerformanceFrequency();
+  const uint64_t start = SDL_GetPerformanceCounter();
+  uint64_t reportTime = start;
+  uint64_t reportTicks = 0;
+  uint64_t numTicks = 0;
+  if (m_renderDevice) {
+    m_renderThread->setCounters(&m_renderDevice->getCounters());
   }
 
-  std::string line;
-  int i = 0;
-  while (std::getline(mapFile, line, '\n')) {
-    int j = 0;
-    std::stringstream ss(line);
-    std::string tileIndexStr;
-
-    while (std::getline(ss, tileIndexStr, ',')) {
-      int tileIndex = std::stoi(tileIndexStr);
+  while (m_isRunning && (maxTicks == 0 || numTicks < maxTicks)) {
+    processInput();
+    tick();
+    numTicks++;
+    if (m_renderDevice) {
+      render();
+    }
 
-      // Extract the two digits from the tileIndex
-      int srcRectY = (tileIndex / 10) * tileSize;
-      int srcRectX = (tileIndex % 10) * tileSize;
+    const uint64_t now = SDL_GetPerformanceCounter();
+    if (now - reportTime >= frequency) {
+      spdlog::info("[Game] headless: {:.0f} ticks/s",
+                   (numTicks - reportTicks) * static_cast<double>(frequency) /
+                       (now - reportTime));
+      reportTime = now;
+      reportTicks = numTicks;
+    }
+  }
 
-      glm::vec2 vecPosition(j * tileSize * scale, i * tileSize * scale);
-      glm::vec2 vecScale(scale, scale);
+  const double seconds =
+      static_cast<double>(SDL_GetPerformanceCounter() - start) / frequency;
+  spdlog::info("[Game] headless: {} ticks in {:.3f} s ({:.0f} ticks/s)",
+               numTicks, seconds, seconds > 0 ? numTicks / seconds : 0.0);
+  if (m_softwareDevice) {
+    const SoftwareRasterizer& rasterizer = m_softwareDevice->getRasterizer();
+    spdlog::info("[Game] software rendering: {} pixels, {:.0f} pixels/s",
+                 rasterizer.getNumPixels(), rasterizer.getPixelsPerSecond());
+    if (!framebufferPath.empty()) {
+      m_softwareDevice->saveFramebuffer(framebufferPath);
+    }
+  }
+}
 
-      Entity tile = m_registry->createEntity();
-      tile.addComponent<TransformComponent>(vecPosition, vecScale, 0);
-      tile.addComponent<SpriteComponent>("tilemap-image", tileSize, tileSize,
-                                         srcRectX, srcRectY);
+void Game::loadTilemap(std::string mapFilePath, std::string spriteFilePath,
+                       uint32_t tileSize, float scale) {
+  if (m_renderDevice) {
+    m_assetStore->addTexture("tilemap-image", spriteFilePath);
+  }
 
-      j++;
+  // the tileset has 10 tiles per row: a tile index "ij" is row i, column j
+  auto& tilemap = m_registry->setResource<Tilemap>("tilemap-image", tileSize,
+                                                   scale, 10);
+  const ArchiveEntry* packedMap = m_assetArchive.find(mapFilePath);
+  if (packedMap && packedMap->type == ARCHIVE_TILEMAP) {
+    if (!tilemap.loadFromMemory(
+            reinterpret_cast<const char*>(m_assetArchive.getData(*packedMap)),
+            packedMap->size)) {
+      spdlog::error("[Game] Failed to load packed map {}", mapFilePath);
+      return;
     }
-    i++;
+  } else if (!tilemap.loadFromFile(mapFilePath)) {
+    return;
   }
 
-  mapFile.close();
+  m_registry->setResource<MapResource>(
+      tilemap.getWidth() * tilemap.getTileWorldSize(),
+      tilemap.getHeight() * tilemap.getTileWorldSize(),
+      tilemap.getTileWorldSize());
 }
 
 void Game::processInput() {
@@ -141,52 +331,133 @@ void Game::processInput() {
   while (SDL_PollEvent(&sdlEvent)) {
     switch (sdlEvent.type) {
     case SDL_QUIT:
-      m_isRunning = false;
+      m_eventBus->emit<QuitEvent>();
+      break;
     case SDL_KEYDOWN:
-      if (sdlEvent.key.keysym.sym == SDLK_ESCAPE) {
-        m_isRunning = false;
+      m_eventBus->enqueue<KeyPressedEvent>(sdlEvent.key.keysym.sym);
+      break;
+    case SDL_KEYUP:
+      m_eventBus->enqueue<KeyReleasedEvent>(sdlEvent.key.keysym.sym);
+      break;
+    case SDL_RENDER_TARGETS_RESET:
+      m_registry->getSystem<RenderSystem>().invalidateStaticLayers();
+      break;
+    case SDL_WINDOWEVENT:
+      switch (sdlEvent.window.event) {
+      case SDL_WINDOWEVENT_SIZE_CHANGED: {
+        windowWidth = sdlEvent.window.data1;
+        windowHeight = sdlEvent.window.data2;
+        auto& camera = m_registry->getResource<CameraResource>();
+        camera.viewport.w = windowWidth;
+        camera.viewport.h = windowHeight;
+        m_isRedrawNeeded = true;
+        break;
+      }
+      case SDL_WINDOWEVENT_MINIMIZED:
+      case SDL_WINDOWEVENT_HIDDEN:
+        m_isWindowHidden = true;
+        break;
+      case SDL_WINDOWEVENT_SHOWN:
+      case SDL_WINDOWEVENT_RESTORED:
+      case SDL_WINDOWEVENT_MAXIMIZED:
+      case SDL_WINDOWEVENT_EXPOSED:
+        m_isWindowHidden = false;
+        m_isRedrawNeeded = true;
+        break;
       }
       break;
     }
   }
+
+  // deliver the input events of this frame before the simulation runs
+  m_eventBus->dispatch();
 }
 
-double Game::getDeltaTime() {
-  // frame cap
-  uint64_t waitMs = MS_PER_FRAME - (SDL_GetTicks64() - m_previousFrameTime);
-  if (waitMs > 0 && waitMs <= MS_PER_FRAME) {
-    // sleep until next frame
-    SDL_Delay(static_cast<uint32_t>(waitMs));
+void Game::onQuit(const QuitEvent& event) { m_isRunning = false; }
+
+void Game::onKeyPressed(const KeyPressedEvent& event) {
+  if (event.key == SDLK_ESCAPE) {
+    m_isRunning = false;
   }
+}
 
-  // delta time (in seconds)
-  double dt = (SDL_GetTicks64() - m_previousFrameTime) / 1000.0;
-  // store the current frame time
-  m_previousFrameTime = SDL_GetTicks64();
+void Game::tick() {
+  auto& frameTime = m_registry->getResource<FrameTimeResource>();
+  frameTime.deltaTime = 1.0 / tickRate;
+  frameTime.frame++;
+  m_registry->update();
 
-  return dt;
+  m_registry->getSystem<TransformHistorySystem>().update();
+  m_registry->getSystem<MovementSystem>().update();
+  m_registry->getSystem<AnimationSystem>().update();
+  m_registry->getSystem<ParticleSystem>().update();
 }
 
 void Game::update() {
-  double dt = getDeltaTime();
-  m_registry->update();
+  const uint64_t now = SDL_GetPerformanceCounter();
+  m_accumulator += static_cast<double>(now - m_previousFrameTime) /
+                   SDL_GetPerformanceFrequency();
+  m_previousFrameTime = now;
+
+  const double tickTime = 1.0 / tickRate;
+  uint8_t numTicks = 0;
+  while (m_accumulator >= tickTime && numTicks < maxTicksPerFrame) {
+    tick();
+    m_accumulator -= tickTime;
+    numTicks++;
+  }
+  if (m_accumulator >= tickTime) {
+    LOG_DEBUG("[Game] simulation behind, dropped {:.1f} ticks",
+              m_accumulator / tickTime);
+    m_accumulator = std::fmod(m_accumulator, tickTime);
+  }
 
-  m_registry->getSystem<MovementSystem>().update(dt);
+  m_registry->getResource<FrameTimeResource>().alpha =
+      static_cast<float>(m_accumulator / tickTime);
 }
 
 void Game::render() {
-  // draw background
-  SDL_SetRenderDrawColor(m_renderer, 21, 21, 21, 255);
-  SDL_RenderClear(m_renderer);
-
-  // draw backgrounds
-  m_registry->getSystem<RenderSystem>().update(m_renderer, *m_assetStore);
-  // render buffer
-  SDL_RenderPresent(m_renderer);
+  RenderSnapshot& snapshot = m_renderThread->getWriteSnapshot();
+  snapshot.clear();
+  snapshot.clearColor = {21, 21, 21, 255};
+  snapshot.isInvalidated = m_isRedrawNeeded;
+  m_isRedrawNeeded = false;
+  m_assetStore->processLoads();
+  m_assetStore->update();
+  auto& renderSystem = m_registry->getSystem<RenderSystem>();
+  renderSystem.update(snapshot, *m_assetStore);
+  snapshot.numCulled = static_cast<uint32_t>(renderSystem.getNumCulled());
+  m_registry->getSystem<ParticleSystem>().extract(snapshot, *m_assetStore);
+  m_registry->getSystem<TextRenderSystem>().update(snapshot, *m_assetStore);
+  m_renderThread->publish();
 }
 
 void Game::destroy() {
-  SDL_DestroyRenderer(m_renderer);
-  SDL_DestroyWindow(m_window);
+  if (!renderStatsPath.empty() && m_renderDevice) {
+    const RenderStats stats = m_renderThread->getStats();
+    const RenderStatSummary drawCalls =
+        stats.summarize(RENDER_STAT_DRAW_CALLS);
+    spdlog::info("[Game] draw calls over the last {} presented frames: min {} "
+                 "avg {:.1f} max {} p99 {}",
+                 drawCalls.numFrames, drawCalls.min, drawCalls.average,
+                 drawCalls.max, drawCalls.p99);
+    stats.writeCsv(renderStatsPath);
+  }
+
+  // textures go before the device that owns them, the device before SDL's
+  m_assetStore->clearAssets();
+  m_renderThread.reset();
+  m_renderDevice.reset();
+  m_backendDevice.reset();
+  if (m_renderer) {
+    SDL_DestroyRenderer(m_renderer);
+  }
+  if (m_window) {
+    SDL_DestroyWindow(m_window);
+  }
+  if (TTF_WasInit()) {
+    TTF_Quit();
+  }
+  IMG_Quit();
   SDL_Quit();
 }
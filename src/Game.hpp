@@ -1,44 +1,134 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include "AssetArchive.hpp"
 #include "AssetStore.hpp"
 #include "ECS.hpp"
+#include "Event.hpp"
+#include "EventBus.hpp"
+#include "render/CountingRenderDevice.hpp"
+#include "render/NullRenderDevice.hpp"
+#include "render/RenderDevice.hpp"
+#include "render/RenderThread.hpp"
+#include "render/SoftwareRenderDevice.hpp"
 #include <SDL2/SDL.h>
 #include <cstdint>
 #include <memory>
+#include <string>
 
-const int FPS = 60;
-const int MS_PER_FRAME = 1000 / FPS;
+const uint16_t DEFAULT_TICK_RATE = 60;
+const uint8_t DEFAULT_MAX_TICKS_PER_FRAME = 5;
+const uint16_t DEFAULT_HIDDEN_FRAME_RATE = 10;
+// Used when the display does not report its refresh rate.
+const uint16_t DEFAULT_DISPLAY_FRAME_RATE = 60;
+
+// Device a headless run renders its frames through.
+enum HeadlessRenderDevice {
+  // Nothing is rendered, only the simulation runs.
+  HEADLESS_RENDER_NONE,
+  // Commands are counted and dropped (`NullRenderDevice`).
+  HEADLESS_RENDER_NULL,
+  // Frames are drawn on the CPU (`SoftwareRenderDevice`).
+  HEADLESS_RENDER_SOFTWARE
+};
 
 class Game {
   private:
     bool m_isRunning;
     uint64_t m_previousFrameTime;
+    // Real time (in seconds) not simulated yet, always below one tick.
+    double m_accumulator;
     std::unique_ptr<Registry> m_registry;
+    // Mapped before and released after the textures read from it.
+    AssetArchive m_assetArchive;
     std::unique_ptr<AssetStore> m_assetStore;
+    std::unique_ptr<EventBus> m_eventBus;
+    std::unique_ptr<RenderThread> m_renderThread;
     SDL_Window* m_window;
     SDL_Renderer* m_renderer;
+    std::unique_ptr<RenderDevice> m_backendDevice;
+    // Device everything renders through: counts, then forwards to the backend.
+    std::unique_ptr<CountingRenderDevice> m_renderDevice;
+    // Backend of a software-rendered headless run, null otherwise.
+    SoftwareRenderDevice* m_softwareDevice;
+    // The window is minimized or hidden: frames are simulated, not rendered.
+    bool m_isWindowHidden;
+    // The window content was lost (exposed, resized): redraw the next frame.
+    bool m_isRedrawNeeded;
+    // Frames per second while the screen is idle, the display refresh rate.
+    uint16_t m_displayFrameRate;
+
+    // Renders through `device`, wrapped in the counting device.
+    void setBackendDevice(std::unique_ptr<RenderDevice> device);
 
     void loadLevel(uint8_t level);
     void setup();
     void loadTilemap(std::string mapFilePath, std::string mapSpriteFilePath,
                      uint32_t tileSize, float scale);
 
+    // Advances the simulation by one fixed tick.
+    void tick();
+
     /**
-     * Calculates the time elapsed since the last frame and enforces a
-     * frame cap.
-     *
-     * This function calculates the delta time (in seconds) since the last
-     * frame, enforces a frame cap by delaying the execution if necessary,
-     * and updates the previous frame time.
-     *
-     * Returns the delta time (in seconds) since the last frame.
+     * Headless loop: ticks as fast as possible, rendering each tick through
+     * `headlessRenderDevice` if any, until the game stops or `maxTicks` ticks
+     * ran, logging the ticks per second.
      */
-    double getDeltaTime();
+    void runHeadless();
+
+    // Sleeps until a frame of a `frameRate` loop started at `frameStart` ends.
+    void waitForFrameEnd(uint64_t frameStart, uint16_t frameRate);
+
+    void onQuit(const QuitEvent& event);
+    void onKeyPressed(const KeyPressedEvent& event);
 
   public:
     uint16_t windowWidth;
     uint16_t windowHeight;
+    /*
+     * Submits frames on a render thread; otherwise renders on the main thread.
+     * Off by default: the SDL renderer is created on the main thread and SDL
+     * does not support driving it from another one on every platform (it
+     * fails on macOS), see `RenderThread`.
+     */
+    bool isRenderThreaded = false;
+    // Simulation ticks per second.
+    uint16_t tickRate = DEFAULT_TICK_RATE;
+    /*
+     * Most ticks simulated per frame. When the game falls further behind, the
+     * backlog is dropped and the simulation slows down instead of spiralling.
+     */
+    uint8_t maxTicksPerFrame = DEFAULT_MAX_TICKS_PER_FRAME;
+    /*
+     * Frames per second while the window is minimized or hidden. The
+     * simulation slows down too, to `maxTicksPerFrame` ticks per frame.
+     */
+    uint16_t hiddenFrameRate = DEFAULT_HIDDEN_FRAME_RATE;
+    /*
+     * Runs without window or renderer (dedicated servers, soak tests, CI),
+     * and without textures unless `headlessRenderDevice` is set. Must be set
+     * before `initialize()`.
+     */
+    bool isHeadless = false;
+    /*
+     * Device headless runs render a frame per tick through. The software
+     * device also logs the pixels per second. Must be set before
+     * `initialize()`.
+     */
+    HeadlessRenderDevice headlessRenderDevice = HEADLESS_RENDER_NONE;
+    // PPM file the last software-rendered frame is written to, if not empty.
+    std::string framebufferPath;
+    // Ticks simulated before a headless run stops, 0 for no limit.
+    uint64_t maxTicks = 0;
+    // Texture memory (bytes) kept under by evicting unused textures, 0: none.
+    uint64_t textureBudget = 0;
+    // CSV file the render statistics are written to on exit, if not empty.
+    std::string renderStatsPath;
+    /*
+     * Archive written by the asset packer (`make pack`), if not empty. The
+     * assets it holds are read from it, the others from their files.
+     */
+    std::string assetArchivePath;
 
     Game();
     ~Game();
@@ -49,19 +139,37 @@ class Game {
      *
      * This function sets up the game and enters the main game loop, which
      * continues to run while the game is in a running state. Within the loop,
-     * it processes input, updates the game state, and renders the game.
+     * it processes input, updates the game state, and renders the game. With
+     * `isRenderThreaded`, the render device is handed over to the render
+     * thread once the level is loaded. Frames that change nothing on screen
+     * are not presented and the loop then paces itself to the display refresh
+     * rate; while the window is hidden, nothing is rendered and the loop runs
+     * at `hiddenFrameRate`.
      */
     void run();
 
     /**
      * Processes input events for the game.
      *
-     * This function polls for SDL events and handles them accordingly. It
-     * checks for quit events and keydown events. If the quit event is
-     * detected or the escape key is pressed, the game will stop running.
+     * This function polls for SDL events and publishes them to the event
+     * bus: quit events are delivered immediately, key events are queued and
+     * dispatched in a batch once all SDL events of the frame were polled. If
+     * the quit event is detected or the escape key is pressed, the game will
+     * stop running.
      */
     void processInput();
+    /**
+     * Runs as many fixed simulation ticks as fit in the time elapsed since the
+     * previous frame (at most `maxTicksPerFrame`) and stores the leftover
+     * fraction of a tick as the interpolation factor used by the renderer.
+     */
     void update();
+
+    /**
+     * Extract stage: writes the frame into the back render snapshot and hands
+     * it to the render thread, if started, which clears, draws and presents
+     * it.
+     */
     void render();
     void destroy();
 };
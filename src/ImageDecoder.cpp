@@ -0,0 +1,84 @@
+#include "ImageDecoder.hpp"
+#include "spdlog/spdlog.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+
+ImageDecoder::ImageDecoder(unsigned numThreads) {
+  if (numThreads == 0) {
+    numThreads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+  }
+  m_numThreads = numThreads;
+}
+
+ImageDecoder::~ImageDecoder() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopping = true;
+    m_jobs.clear();
+  }
+  m_jobCondition.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+  for (auto& image : m_decoded) {
+    SDL_FreeSurface(image.surface);
+  }
+}
+
+void ImageDecoder::workerLoop() {
+  for (;;) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobCondition.wait(lock,
+                        [this] { return !m_jobs.empty() || m_isStopping; });
+    if (m_isStopping) {
+      return;
+    }
+    Job job = std::move(m_jobs.front());
+    m_jobs.pop_front();
+    lock.unlock();
+
+    // SDL errors are per thread, so the message is this image's
+    SDL_Surface* surface = IMG_Load(job.filePath.c_str());
+    if (!surface) {
+      spdlog::error("[ImageDecoder] Failed to load texture {}: {}",
+                    job.filePath, IMG_GetError());
+    }
+
+    lock.lock();
+    m_decoded.push_back({job.id, surface});
+    lock.unlock();
+    m_doneCondition.notify_all();
+  }
+}
+
+void ImageDecoder::decode(uint32_t id, const std::string& filePath) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_workers.empty()) {
+      for (unsigned i = 0; i < m_numThreads; i++) {
+        m_workers.emplace_back(&ImageDecoder::workerLoop, this);
+      }
+    }
+    m_jobs.push_back({id, filePath});
+    m_numPending++;
+  }
+  m_jobCondition.notify_one();
+}
+
+void ImageDecoder::collect(std::vector<DecodedImage>& images) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  images.insert(images.end(), m_decoded.begin(), m_decoded.end());
+  m_numPending -= m_decoded.size();
+  m_decoded.clear();
+}
+
+void ImageDecoder::wait() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_doneCondition.wait(lock,
+                       [this] { return m_decoded.size() == m_numPending; });
+}
+
+size_t ImageDecoder::getNumPending() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_numPending;
+}
@@ -0,0 +1,65 @@
+#ifndef IMAGEDECODER_HPP
+#define IMAGEDECODER_HPP
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Image decoded by an `ImageDecoder`; `surface` is null if decoding failed.
+struct DecodedImage {
+    uint32_t id;
+    SDL_Surface* surface;
+};
+
+/**
+ * Decodes image files with `IMG_Load` on a pool of worker threads, so loading
+ * many images scales with the cores and never blocks the caller. Results are
+ * handed back in completion order by `collect`; their surfaces belong to the
+ * caller. Workers start with the first request. `IMG_Init` must have loaded
+ * the image formats before, as SDL_image initializes them lazily otherwise.
+ */
+class ImageDecoder {
+  private:
+    struct Job {
+        uint32_t id;
+        std::string filePath;
+    };
+
+    unsigned m_numThreads;
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_jobCondition;
+    std::condition_variable m_doneCondition;
+    std::deque<Job> m_jobs;
+    std::vector<DecodedImage> m_decoded;
+    // Requests not collected yet: queued, decoding or decoded.
+    size_t m_numPending = 0;
+    bool m_isStopping = false;
+
+    void workerLoop();
+
+  public:
+    // `numThreads` workers; 0 uses one per core minus the calling thread, at
+    // least one.
+    ImageDecoder(unsigned numThreads = 0);
+    // Waits for the images being decoded and frees the uncollected ones.
+    ~ImageDecoder();
+
+    // Queues `filePath` for decoding; `id` identifies the result.
+    void decode(uint32_t id, const std::string& filePath);
+
+    // Moves the images decoded so far to the end of `images`.
+    void collect(std::vector<DecodedImage>& images);
+
+    // Blocks until every queued image is decoded.
+    void wait();
+
+    size_t getNumPending();
+};
+
+#endif
@@ -1,8 +1,132 @@
 #include "Game.hpp"
+#include "spdlog/spdlog.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 
+// Value of the option at `argv[i]`, moving `i` past it; null if it is missing.
+const char* getOptionValue(int argc, char* argv[], int& i) {
+  if (i + 1 >= argc) {
+    spdlog::error("Missing value for {}", argv[i]);
+    return nullptr;
+  }
+  return argv[++i];
+}
+
+/*
+ * Parses the value of the option at `argv[i]` as a number in [min, max],
+ * moving `i` past it. Returns false if it is missing or invalid.
+ */
+bool getOptionNumber(int argc, char* argv[], int& i, uint64_t min,
+                     uint64_t max, uint64_t& value) {
+  const char* option = argv[i];
+  const char* text = getOptionValue(argc, argv, i);
+  if (!text) {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  const unsigned long long number = std::strtoull(text, &end, 10);
+  if (*text < '0' || *text > '9' || *end != '\0' || errno == ERANGE ||
+      number < min || number > max) {
+    spdlog::error("Invalid value {} for {}, expected a number in [{}, {}]",
+                  text, option, min, max);
+    return false;
+  }
+  value = number;
+  return true;
+}
+
+/*
+ * Options:
+ *   --headless       simulate without window or rendering, as fast as possible
+ *   --ticks N        stop a headless run after N ticks
+ *   --render-device null|software
+ *                    headless run rendering each tick through the null device
+ *                    (CPU cost of rendering only) or the software one
+ *                    (drawing on the CPU, logging the pixels per second)
+ *   --software       same as --render-device software
+ *   --framebuffer F  write the last software-rendered frame to the PPM file F
+ *   --tick-rate N    simulation ticks per second (default 60)
+ *   --texture-budget N
+ *                    keep textures under N MiB by evicting unused ones
+ *   --render-stats F write the render statistics of the last frames to the
+ *                    CSV file F on exit
+ *   --assets F       read the assets packed in the archive F (`make pack`)
+ *   --render-thread  submit frames on a render thread (not supported by SDL
+ *                    on every platform, e.g. macOS)
+ *
+ * Unknown options, missing values and invalid numbers exit with an error.
+ */
 int main(int argc, char* argv[]) {
   Game game;
 
+  for (int i = 1; i < argc; i++) {
+    const char* option = argv[i];
+    const char* text = nullptr;
+    uint64_t number = 0;
+    if (std::strcmp(option, "--headless") == 0) {
+      game.isHeadless = true;
+    } else if (std::strcmp(option, "--render-device") == 0) {
+      text = getOptionValue(argc, argv, i);
+      if (!text) {
+        return EXIT_FAILURE;
+      }
+      game.isHeadless = true;
+      if (std::strcmp(text, "null") == 0) {
+        game.headlessRenderDevice = HEADLESS_RENDER_NULL;
+      } else if (std::strcmp(text, "software") == 0) {
+        game.headlessRenderDevice = HEADLESS_RENDER_SOFTWARE;
+      } else {
+        spdlog::error("Unknown render device {}, expected null or software",
+                      text);
+        return EXIT_FAILURE;
+      }
+    } else if (std::strcmp(option, "--software") == 0) {
+      game.isHeadless = true;
+      game.headlessRenderDevice = HEADLESS_RENDER_SOFTWARE;
+    } else if (std::strcmp(option, "--framebuffer") == 0) {
+      text = getOptionValue(argc, argv, i);
+      if (!text) {
+        return EXIT_FAILURE;
+      }
+      game.framebufferPath = text;
+    } else if (std::strcmp(option, "--ticks") == 0) {
+      if (!getOptionNumber(argc, argv, i, 1, UINT64_MAX, number)) {
+        return EXIT_FAILURE;
+      }
+      game.maxTicks = number;
+    } else if (std::strcmp(option, "--tick-rate") == 0) {
+      if (!getOptionNumber(argc, argv, i, 1, UINT16_MAX, number)) {
+        return EXIT_FAILURE;
+      }
+      game.tickRate = static_cast<uint16_t>(number);
+    } else if (std::strcmp(option, "--texture-budget") == 0) {
+      if (!getOptionNumber(argc, argv, i, 0, UINT64_MAX >> 20, number)) {
+        return EXIT_FAILURE;
+      }
+      game.textureBudget = number << 20;
+    } else if (std::strcmp(option, "--render-stats") == 0) {
+      text = getOptionValue(argc, argv, i);
+      if (!text) {
+        return EXIT_FAILURE;
+      }
+      game.renderStatsPath = text;
+    } else if (std::strcmp(option, "--assets") == 0) {
+      text = getOptionValue(argc, argv, i);
+      if (!text) {
+        return EXIT_FAILURE;
+      }
+      game.assetArchivePath = text;
+    } else if (std::strcmp(option, "--render-thread") == 0) {
+      game.isRenderThreaded = true;
+    } else {
+      spdlog::error("Unknown option {}", option);
+      return EXIT_FAILURE;
+    }
+  }
+
   game.initialize();
   game.run();
   game.destroy();
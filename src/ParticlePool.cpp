@@ -0,0 +1,109 @@
+#include "ParticlePool.hpp"
+#include <algorithm>
+
+#ifdef __SSE2__
+#define FLATLAND_PARTICLES_SSE2
+#include <emmintrin.h>
+#endif
+
+ParticlePool::ParticlePool(std::string assetId, SDL_Rect srcRect,
+                           uint8_t zIndex) {
+  this->assetId = assetId;
+  this->srcRect = srcRect;
+  this->zIndex = zIndex;
+}
+
+void ParticlePool::grow() {
+  const size_t capacity = std::max<size_t>(64, m_positionX.size() * 2);
+  m_positionX.resize(capacity);
+  m_positionY.resize(capacity);
+  m_velocityX.resize(capacity);
+  m_velocityY.resize(capacity);
+  m_life.resize(capacity);
+  m_inverseLifetime.resize(capacity);
+  m_startColor.resize(capacity);
+  m_endColor.resize(capacity);
+}
+
+void ParticlePool::emit(float x, float y, float velocityX, float velocityY,
+                        float lifetime, SDL_Color startColor,
+                        SDL_Color endColor) {
+  if (m_numParticles == m_positionX.size()) {
+    grow();
+  }
+  const size_t i = m_numParticles++;
+  m_positionX[i] = x;
+  m_positionY[i] = y;
+  m_velocityX[i] = velocityX;
+  m_velocityY[i] = velocityY;
+  m_life[i] = lifetime;
+  m_inverseLifetime[i] = 1.0f / lifetime;
+  m_startColor[i] = expandColor(startColor);
+  m_endColor[i] = expandColor(endColor);
+}
+
+void ParticlePool::kill(uint32_t index) {
+  const size_t last = --m_numParticles;
+  if (index == last) {
+    return;
+  }
+  m_positionX[index] = m_positionX[last];
+  m_positionY[index] = m_positionY[last];
+  m_velocityX[index] = m_velocityX[last];
+  m_velocityY[index] = m_velocityY[last];
+  m_life[index] = m_life[last];
+  m_inverseLifetime[index] = m_inverseLifetime[last];
+  m_startColor[index] = m_startColor[last];
+  m_endColor[index] = m_endColor[last];
+}
+
+void ParticlePool::update(float dt) {
+  m_dead.clear();
+  float* positionX = m_positionX.data();
+  float* positionY = m_positionY.data();
+  const float* velocityX = m_velocityX.data();
+  const float* velocityY = m_velocityY.data();
+  float* life = m_life.data();
+
+  // whole groups of 4: the lanes past the last particle are padding
+#ifdef FLATLAND_PARTICLES_SSE2
+  const __m128 step = _mm_set1_ps(dt);
+  const __m128 zero = _mm_setzero_ps();
+  for (size_t i = 0; i < m_numParticles; i += 4) {
+    _mm_storeu_ps(positionX + i,
+                  _mm_add_ps(_mm_loadu_ps(positionX + i),
+                             _mm_mul_ps(_mm_loadu_ps(velocityX + i), step)));
+    _mm_storeu_ps(positionY + i,
+                  _mm_add_ps(_mm_loadu_ps(positionY + i),
+                             _mm_mul_ps(_mm_loadu_ps(velocityY + i), step)));
+    const __m128 remaining = _mm_sub_ps(_mm_loadu_ps(life + i), step);
+    _mm_storeu_ps(life + i, remaining);
+
+    const int deadLanes = _mm_movemask_ps(_mm_cmple_ps(remaining, zero));
+    if (deadLanes != 0) {
+      for (int lane = 0; lane < 4; lane++) {
+        if ((deadLanes & (1 << lane)) && i + lane < m_numParticles) {
+          m_dead.push_back(static_cast<uint32_t>(i + lane));
+        }
+      }
+    }
+  }
+#else
+  for (size_t i = 0; i < m_numParticles; i++) {
+    positionX[i] += velocityX[i] * dt;
+    positionY[i] += velocityY[i] * dt;
+    life[i] -= dt;
+    if (life[i] <= 0) {
+      m_dead.push_back(static_cast<uint32_t>(i));
+    }
+  }
+#endif
+
+  /*
+   * Compact from the highest index down: every particle after the one being
+   * removed is alive, so the last particle can take its place.
+   */
+  for (auto dead = m_dead.rbegin(); dead != m_dead.rend(); ++dead) {
+    kill(*dead);
+  }
+}
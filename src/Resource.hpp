@@ -0,0 +1,65 @@
+#ifndef RESOURCE_HPP
+#define RESOURCE_HPP
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+/*
+ * Resources are the global, per-registry state shared between systems. They
+ * are stored once in the registry (see `Registry::setResource`) instead of
+ * being attached to an entity.
+ */
+
+struct FrameTimeResource {
+    // Duration (in seconds) of a simulation tick. Constant between ticks.
+    double deltaTime;
+    // Number of ticks simulated so far.
+    uint64_t frame;
+    /*
+     * Fraction of a tick elapsed since the last simulated one, in [0, 1).
+     * Rendering blends the previous and current transforms by this amount.
+     */
+    float alpha;
+
+    FrameTimeResource(double deltaTime = 0.0, uint64_t frame = 0) {
+      this->deltaTime = deltaTime;
+      this->frame = frame;
+      this->alpha = 0;
+    }
+};
+
+struct MapResource {
+    // Map dimensions in world units (pixels, after scaling).
+    float width;
+    float height;
+    // Size of one tile in world units.
+    float tileSize;
+
+    MapResource(float width = 0, float height = 0, float tileSize = 0) {
+      this->width = width;
+      this->height = height;
+      this->tileSize = tileSize;
+    }
+};
+
+struct CameraResource {
+    // World position shown at the top-left corner of the viewport.
+    glm::vec2 position;
+    // Screen pixels per world unit.
+    float zoom;
+    // Screen area the camera renders to.
+    SDL_Rect viewport;
+
+    CameraResource(glm::vec2 position = glm::vec2(0, 0), float zoom = 1.0,
+                   SDL_Rect viewport = {0, 0, 0, 0}) {
+      this->position = position;
+      this->zoom = zoom;
+      this->viewport = viewport;
+    }
+
+    glm::vec2 worldToScreen(glm::vec2 point) const {
+      return glm::vec2(viewport.x, viewport.y) + (point - position) * zoom;
+    }
+};
+
+#endif
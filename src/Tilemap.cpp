@@ -0,0 +1,139 @@
+#include "Tilemap.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <fstream>
+
+Tilemap::Tilemap(std::string assetId, int tileSize, float scale,
+                 int tilesetColumns) {
+  this->assetId = assetId;
+  this->tileSize = tileSize;
+  this->scale = scale;
+  this->tilesetColumns = tilesetColumns;
+}
+
+size_t Tilemap::getTileOffset(int x, int y) const {
+  const int chunkIndex =
+      (y / TILEMAP_CHUNK_SIZE) * m_numChunksX + (x / TILEMAP_CHUNK_SIZE);
+  return static_cast<size_t>(chunkIndex) * TILEMAP_CHUNK_SIZE *
+             TILEMAP_CHUNK_SIZE +
+         (y % TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE +
+         (x % TILEMAP_CHUNK_SIZE);
+}
+
+void Tilemap::resize(int width, int height) {
+  m_width = width;
+  m_height = height;
+  m_numChunksX = (width + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+  m_numChunksY = (height + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+  m_tiles.assign(static_cast<size_t>(m_numChunksX) * m_numChunksY *
+                     TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE,
+                 TILE_EMPTY);
+  m_chunkNumTiles.assign(static_cast<size_t>(m_numChunksX) * m_numChunksY, 0);
+  m_version++;
+}
+
+void Tilemap::setTile(int x, int y, uint16_t tile) {
+  uint16_t& cell = m_tiles[getTileOffset(x, y)];
+  uint16_t& chunkNumTiles =
+      m_chunkNumTiles[(y / TILEMAP_CHUNK_SIZE) * m_numChunksX +
+                      (x / TILEMAP_CHUNK_SIZE)];
+
+  if (cell == TILE_EMPTY && tile != TILE_EMPTY) {
+    chunkNumTiles++;
+  } else if (cell != TILE_EMPTY && tile == TILE_EMPTY) {
+    chunkNumTiles--;
+  }
+  cell = tile;
+  m_version++;
+}
+
+bool Tilemap::loadFromFile(const std::string& filePath) {
+  std::ifstream mapFile(filePath, std::ios::binary);
+  if (!mapFile.is_open()) {
+    spdlog::error("[Tilemap] Failed to open map file: {}", filePath);
+    return false;
+  }
+  mapFile.seekg(0, std::ios::end);
+  const std::streamoff fileSize = mapFile.tellg();
+  if (fileSize < 0) {
+    spdlog::error("[Tilemap] Failed to read map file: {}", filePath);
+    return false;
+  }
+  std::string text(static_cast<size_t>(fileSize), '\0');
+  mapFile.seekg(0, std::ios::beg);
+  if (!mapFile.read(&text[0], text.size())) {
+    spdlog::error("[Tilemap] Failed to read map file: {}", filePath);
+    return false;
+  }
+
+  if (!loadFromMemory(text.data(), text.size())) {
+    spdlog::error("[Tilemap] Failed to load map file: {}", filePath);
+    return false;
+  }
+  spdlog::info("[Tilemap] Loaded {}x{} tiles from {}", m_width, m_height,
+               filePath);
+  return true;
+}
+
+bool Tilemap::loadFromMemory(const char* data, size_t size) {
+  const char* end = data + size;
+  if (std::none_of(data, end, [](char c) { return c >= '0' && c <= '9'; })) {
+    spdlog::error("[Tilemap] Map data of {} bytes has no tile indices", size);
+    return false;
+  }
+
+  // the first row gives the width, the number of lines the height
+  const char* firstLineEnd = std::find(data, end, '\n');
+  const int width = static_cast<int>(std::count(data, firstLineEnd, ',') + 1);
+  int height = static_cast<int>(std::count(data, end, '\n'));
+  if (size > 0 && end[-1] != '\n') {
+    height++;
+  }
+  resize(width, height);
+
+  const char* c = data;
+  size_t numInvalid = 0;
+  for (int y = 0; y < m_height && c < end; y++) {
+    // the cells of a row are contiguous inside each chunk
+    uint16_t* rowTiles = &m_tiles[getTileOffset(0, y)];
+    uint16_t* chunkNumTiles =
+        &m_chunkNumTiles[(y / TILEMAP_CHUNK_SIZE) * m_numChunksX];
+    int x = 0;
+    while (c < end && *c != '\n') {
+      int value = 0;
+      bool hasDigits = false;
+      for (; c < end && *c != ',' && *c != '\n'; c++) {
+        if (*c >= '0' && *c <= '9') {
+          // stops growing once out of range, so it cannot overflow
+          if (value < TILE_EMPTY) {
+            value = value * 10 + (*c - '0');
+          }
+          hasDigits = true;
+        }
+      }
+      if (hasDigits && value >= TILE_EMPTY) {
+        numInvalid++;
+      } else if (hasDigits && x < m_width) {
+        const int chunkX = x / TILEMAP_CHUNK_SIZE;
+        rowTiles[chunkX * TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE +
+                 x % TILEMAP_CHUNK_SIZE] = static_cast<uint16_t>(value);
+        chunkNumTiles[chunkX]++;
+      }
+      x++;
+      if (c < end && *c == ',') {
+        c++;
+      }
+    }
+    // the last row may have no line break
+    if (c < end) {
+      c++;
+    }
+  }
+
+  if (numInvalid > 0) {
+    spdlog::error("[Tilemap] Left {} cells empty: tile indices must be "
+                  "below {}",
+                  numInvalid, TILE_EMPTY);
+  }
+  return true;
+}
@@ -0,0 +1,87 @@
+#ifndef TILEMAP_HPP
+#define TILEMAP_HPP
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Side, in tiles, of the square chunks the tile grid is stored in.
+const int TILEMAP_CHUNK_SIZE = 32;
+// Tile index of a cell without tile.
+const uint16_t TILE_EMPTY = 0xffff;
+
+/**
+ * Tile grid stored as a resource instead of one entity per tile. Tiles are
+ * `uint16_t` tileset indices (2 bytes per cell), laid out chunk by chunk so the
+ * tiles of a chunk are contiguous. Source rectangles are computed from the
+ * index when rendering (see `TilemapRenderer`).
+ */
+class Tilemap {
+  private:
+    // Map size, in tiles.
+    int m_width = 0;
+    int m_height = 0;
+    // Map size, in chunks.
+    int m_numChunksX = 0;
+    int m_numChunksY = 0;
+
+    std::vector<uint16_t> m_tiles;
+    // Number of non-empty tiles per chunk, to skip empty chunks.
+    std::vector<uint16_t> m_chunkNumTiles;
+    // Incremented by every change of the tiles.
+    uint32_t m_version = 0;
+
+    size_t getTileOffset(int x, int y) const;
+    void resize(int width, int height);
+
+  public:
+    // Tileset texture in the AssetStore.
+    std::string assetId;
+    // Size of a tile in the tileset, in pixels.
+    int tileSize;
+    // World units per tileset pixel.
+    float scale;
+    // Number of tiles per row in the tileset.
+    int tilesetColumns;
+
+    Tilemap(std::string assetId = "", int tileSize = 32, float scale = 1.0,
+            int tilesetColumns = 10);
+
+    /**
+     * Loads a map file: one line per tile row, with comma separated tileset
+     * indices. Returns false (and logs) if the file cannot be read.
+     */
+    bool loadFromFile(const std::string& filePath);
+
+    // Loads the contents of a map file, like a packed asset archive's.
+    // Indices of TILE_EMPTY or more are logged and left empty. Returns false,
+    // leaving the map unchanged, if the data has no tile index at all.
+    bool loadFromMemory(const char* data, size_t size);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getNumChunksX() const { return m_numChunksX; }
+    int getNumChunksY() const { return m_numChunksY; }
+
+    // Size of a tile in world units.
+    float getTileWorldSize() const { return tileSize * scale; }
+
+    uint16_t getTile(int x, int y) const { return m_tiles[getTileOffset(x, y)]; }
+    void setTile(int x, int y, uint16_t tile);
+
+    // Changes whenever the tiles change, for caches of the tiles.
+    uint32_t getVersion() const { return m_version; }
+
+    bool isChunkEmpty(int chunkX, int chunkY) const {
+      return m_chunkNumTiles[chunkY * m_numChunksX + chunkX] == 0;
+    }
+
+    // Source rectangle of a tile index in the tileset texture.
+    SDL_Rect getTileSrcRect(uint16_t tile) const {
+      return {(tile % tilesetColumns) * tileSize,
+              (tile / tilesetColumns) * tileSize, tileSize, tileSize};
+    }
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef WORLD_HPP
+#define WORLD_HPP
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Compile-time index of the type T inside the type list Ts. Used by `World`
+ * and `Systems` to turn a component or system type into a constant.
+ */
+template <typename T, typename... Ts> struct TypeListIndex;
+
+template <typename T, typename... Ts>
+struct TypeListIndex<T, T, Ts...> : std::integral_constant<size_t, 0> {};
+
+template <typename T, typename U, typename... Ts>
+struct TypeListIndex<T, U, Ts...>
+    : std::integral_constant<size_t, 1 + TypeListIndex<T, Ts...>::value> {};
+
+template <typename T, typename... Ts>
+constexpr bool typeListContains = (std::is_same_v<T, Ts> || ...);
+
+// ------------ World ----------------------------------------------------------
+
+/**
+ * Statically typed counterpart of `Registry` for shipping builds, where the
+ * full list of component types is known up front. Pools live in a
+ * `std::tuple` of vectors and the component id is a compile-time constant, so
+ * every access is a direct array index: no hash lookups, no `shared_ptr` and
+ * no virtual calls.
+ */
+template <typename... TComponents> class World {
+  public:
+    typedef std::bitset<sizeof...(TComponents)> WorldSignature;
+
+  private:
+    // Number of entities added to the world.
+    uint16_t m_numEntities = 0;
+
+    // One pool per component type. Pool index is the entity ID.
+    std::tuple<std::vector<TComponents>...> m_componentPools;
+
+    /**
+     * Collection of component signatures per entity. Collection index is the
+     * entity ID.
+     */
+    std::vector<WorldSignature> m_entityComponentSignatures;
+
+    template <typename TComponent> std::vector<TComponent>& getPool() {
+      return std::get<getComponentId<TComponent>()>(m_componentPools);
+    }
+
+    template <typename TComponent>
+    const std::vector<TComponent>& getPool() const {
+      return std::get<getComponentId<TComponent>()>(m_componentPools);
+    }
+
+  public:
+    // Compile-time identifier of a component type in this world.
+    template <typename TComponent> static constexpr size_t getComponentId() {
+      static_assert(typeListContains<TComponent, TComponents...>,
+                    "Component type is not part of this World.");
+      return TypeListIndex<TComponent, TComponents...>::value;
+    }
+
+    // Signature that matches entities holding all the TRequired components.
+    template <typename... TRequired>
+    static WorldSignature getSignature() {
+      WorldSignature signature;
+      (signature.set(getComponentId<TRequired>()), ...);
+      return signature;
+    }
+
+    uint16_t getNumEntities() const { return m_numEntities; }
+
+    uint16_t createEntity() {
+      uint16_t entityId = m_numEntities++;
+      if (entityId >= m_entityComponentSignatures.size()) {
+        m_entityComponentSignatures.resize(entityId + 1);
+      }
+      return entityId;
+    }
+
+    /**
+     * Adds a new component of type TComponent to the specified entity.
+     * Forwards the provided arguments to the constructor of the component.
+     */
+    template <typename TComponent, typename... TArgs>
+    void addComponent(uint16_t entityId, TArgs&&... args) {
+      auto& pool = getPool<TComponent>();
+      if (entityId >= pool.size()) {
+        pool.resize(m_numEntities);
+      }
+      pool[entityId] = TComponent(std::forward<TArgs>(args)...);
+      m_entityComponentSignatures[entityId].set(getComponentId<TComponent>());
+    }
+
+    template <typename TComponent> void removeComponent(uint16_t entityId) {
+      m_entityComponentSignatures[entityId].reset(
+          getComponentId<TComponent>());
+    }
+
+    template <typename TComponent> bool hasComponent(uint16_t entityId) const {
+      return m_entityComponentSignatures[entityId].test(
+          getComponentId<TComponent>());
+    }
+
+    template <typename TComponent> TComponent& getComponent(uint16_t entityId) {
+      return getPool<TComponent>()[entityId];
+    }
+
+    template <typename TComponent>
+    const TComponent& getComponent(uint16_t entityId) const {
+      return getPool<TComponent>()[entityId];
+    }
+
+    /**
+     * Calls `func(entityId, TRequired&...)` for every entity that holds all the
+     * TRequired components. The pools are resolved once, before the loop.
+     */
+    template <typename... TRequired, typename TFunc> void each(TFunc&& func) {
+      const WorldSignature signature = getSignature<TRequired...>();
+      auto pools = std::forward_as_tuple(getPool<TRequired>()...);
+
+      for (uint16_t entityId = 0; entityId < m_numEntities; entityId++) {
+        if ((m_entityComponentSignatures[entityId] & signature) != signature) {
+          continue;
+        }
+        std::apply(
+            [&](auto&... pool) { func(entityId, pool[entityId]...); }, pools);
+      }
+    }
+};
+
+// ------------ Systems --------------------------------------------------------
+
+/**
+ * Fixed set of systems stored by value in a `std::tuple`. Lookups are resolved
+ * at compile time, replacing the `std::type_index` map used by `Registry`.
+ */
+template <typename... TSystems> class Systems {
+  private:
+    std::tuple<TSystems...> m_systems;
+
+  public:
+    template <typename TSystem> static constexpr bool hasSystem() {
+      return typeListContains<TSystem, TSystems...>;
+    }
+
+    template <typename TSystem> TSystem& getSystem() {
+      static_assert(hasSystem<TSystem>(), "System is not part of this set.");
+      return std::get<TypeListIndex<TSystem, TSystems...>::value>(m_systems);
+    }
+
+    // Calls `func(system)` for every system, in declaration order.
+    template <typename TFunc> void forEach(TFunc&& func) {
+      std::apply([&](auto&... system) { (func(system), ...); }, m_systems);
+    }
+};
+
+#endif
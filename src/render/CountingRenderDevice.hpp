@@ -0,0 +1,59 @@
+#ifndef COUNTINGRENDERDEVICE_HPP
+#define COUNTINGRENDERDEVICE_HPP
+#include "RenderDevice.hpp"
+
+/**
+ * `RenderDevice` that forwards every command to another device and counts
+ * them, so the render statistics of the live backend come for the cost of a
+ * few increments. The counters follow the threading rules of the device.
+ */
+class CountingRenderDevice : public RenderDevice {
+  private:
+    RenderDevice* m_target;
+    RenderDeviceCounters m_counters;
+
+  public:
+    CountingRenderDevice(RenderDevice* target) : m_target(target) {}
+
+    TextureHandle createTexture(SDL_Surface* surface) override {
+      m_counters.numTexturesCreated++;
+      m_counters.numBytesUploaded += getSurfaceTextureSize(surface);
+      return m_target->createTexture(surface);
+    }
+
+    TextureHandle createRenderTarget(int width, int height) override {
+      m_counters.numTexturesCreated++;
+      return m_target->createRenderTarget(width, height);
+    }
+
+    void destroyTexture(TextureHandle texture) override {
+      m_counters.numTexturesDestroyed++;
+      m_target->destroyTexture(texture);
+    }
+
+    void setRenderTarget(TextureHandle target) override {
+      m_counters.numTargetSwitches++;
+      m_target->setRenderTarget(target);
+    }
+
+    void clear(SDL_Color color) override {
+      m_counters.numClears++;
+      m_target->clear(color);
+    }
+
+    void drawQuads(TextureHandle texture, const SpriteQuad* quads,
+                   size_t count) override {
+      m_counters.countDraw(texture, count);
+      m_target->drawQuads(texture, quads, count);
+    }
+
+    void present() override {
+      m_counters.countPresent();
+      m_target->present();
+    }
+
+    // Totals since the device was created.
+    const RenderDeviceCounters& getCounters() const { return m_counters; }
+};
+
+#endif
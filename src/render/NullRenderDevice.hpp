@@ -0,0 +1,48 @@
+#ifndef NULLRENDERDEVICE_HPP
+#define NULLRENDERDEVICE_HPP
+#include "RenderDevice.hpp"
+#include <cstdint>
+
+/**
+ * `RenderDevice` that draws nothing and only counts the commands it receives,
+ * to measure the CPU side of rendering without SDL or driver costs.
+ */
+class NullRenderDevice : public RenderDevice {
+  private:
+    RenderDeviceCounters m_counters;
+    TextureHandle m_nextHandle = 1;
+
+  public:
+    TextureHandle createTexture(SDL_Surface* surface) override {
+      m_counters.numTexturesCreated++;
+      m_counters.numBytesUploaded += getSurfaceTextureSize(surface);
+      return m_nextHandle++;
+    }
+
+    TextureHandle createRenderTarget(int width, int height) override {
+      m_counters.numTexturesCreated++;
+      return m_nextHandle++;
+    }
+
+    void destroyTexture(TextureHandle texture) override {
+      m_counters.numTexturesDestroyed++;
+    }
+
+    void setRenderTarget(TextureHandle target) override {
+      m_counters.numTargetSwitches++;
+    }
+
+    void clear(SDL_Color color) override { m_counters.numClears++; }
+
+    void drawQuads(TextureHandle texture, const SpriteQuad* quads,
+                   size_t count) override {
+      m_counters.countDraw(texture, count);
+    }
+
+    void present() override { m_counters.countPresent(); }
+
+    const RenderDeviceCounters& getCounters() const { return m_counters; }
+    void resetCounters() { m_counters = RenderDeviceCounters(); }
+};
+
+#endif
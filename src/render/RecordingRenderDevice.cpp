@@ -0,0 +1,122 @@
+#include "RecordingRenderDevice.hpp"
+
+void RenderCapture::replay(RenderDevice& device) const {
+  // handles of the textures created during the capture, recorded -> replayed
+  std::unordered_map<TextureHandle, TextureHandle> created;
+  auto resolve = [&created](TextureHandle texture) {
+    auto entry = created.find(texture);
+    return entry == created.end() ? texture : entry->second;
+  };
+
+  for (const auto& command : commands) {
+    switch (command.type) {
+    case CREATE_TEXTURE:
+    case CREATE_RENDER_TARGET:
+      created[command.texture] =
+          device.createRenderTarget(command.width, command.height);
+      break;
+    case DESTROY_TEXTURE:
+      if (created.count(command.texture)) {
+        device.destroyTexture(created[command.texture]);
+        created.erase(command.texture);
+      }
+      break;
+    case SET_RENDER_TARGET:
+      device.setRenderTarget(resolve(command.texture));
+      break;
+    case CLEAR:
+      device.clear(command.color);
+      break;
+    case DRAW_QUADS:
+      device.drawQuads(resolve(command.texture), &quads[command.firstQuad],
+                       command.numQuads);
+      break;
+    case PRESENT:
+      device.present();
+      break;
+    }
+  }
+
+  for (auto& texture : created) {
+    device.destroyTexture(texture.second);
+  }
+}
+
+void RecordingRenderDevice::record(RenderCommandType type,
+                                   TextureHandle texture) {
+  if (!m_isRecording) {
+    return;
+  }
+  RenderCommand command = {};
+  command.type = type;
+  command.texture = texture;
+  m_capture.commands.push_back(command);
+}
+
+TextureHandle RecordingRenderDevice::createTexture(SDL_Surface* surface) {
+  const TextureHandle texture =
+      m_target ? m_target->createTexture(surface) : m_nextHandle++;
+  record(CREATE_TEXTURE, texture);
+  if (m_isRecording) {
+    m_capture.commands.back().width = surface->w;
+    m_capture.commands.back().height = surface->h;
+  }
+  return texture;
+}
+
+TextureHandle RecordingRenderDevice::createRenderTarget(int width,
+                                                        int height) {
+  const TextureHandle texture =
+      m_target ? m_target->createRenderTarget(width, height) : m_nextHandle++;
+  record(CREATE_RENDER_TARGET, texture);
+  if (m_isRecording) {
+    m_capture.commands.back().width = width;
+    m_capture.commands.back().height = height;
+  }
+  return texture;
+}
+
+void RecordingRenderDevice::destroyTexture(TextureHandle texture) {
+  record(DESTROY_TEXTURE, texture);
+  if (m_target) {
+    m_target->destroyTexture(texture);
+  }
+}
+
+void RecordingRenderDevice::setRenderTarget(TextureHandle target) {
+  record(SET_RENDER_TARGET, target);
+  if (m_target) {
+    m_target->setRenderTarget(target);
+  }
+}
+
+void RecordingRenderDevice::clear(SDL_Color color) {
+  record(CLEAR, NULL_TEXTURE);
+  if (m_isRecording) {
+    m_capture.commands.back().color = color;
+  }
+  if (m_target) {
+    m_target->clear(color);
+  }
+}
+
+void RecordingRenderDevice::drawQuads(TextureHandle texture,
+                                      const SpriteQuad* quads, size_t count) {
+  record(DRAW_QUADS, texture);
+  if (m_isRecording) {
+    m_capture.commands.back().firstQuad =
+        static_cast<uint32_t>(m_capture.quads.size());
+    m_capture.commands.back().numQuads = static_cast<uint32_t>(count);
+    m_capture.quads.insert(m_capture.quads.end(), quads, quads + count);
+  }
+  if (m_target) {
+    m_target->drawQuads(texture, quads, count);
+  }
+}
+
+void RecordingRenderDevice::present() {
+  record(PRESENT, NULL_TEXTURE);
+  if (m_target) {
+    m_target->present();
+  }
+}
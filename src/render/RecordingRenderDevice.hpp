@@ -0,0 +1,90 @@
+#ifndef RECORDINGRENDERDEVICE_HPP
+#define RECORDINGRENDERDEVICE_HPP
+#include "RenderDevice.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+enum RenderCommandType {
+  CREATE_TEXTURE,
+  CREATE_RENDER_TARGET,
+  DESTROY_TEXTURE,
+  SET_RENDER_TARGET,
+  CLEAR,
+  DRAW_QUADS,
+  PRESENT
+};
+
+struct RenderCommand {
+    RenderCommandType type;
+    // Texture created, destroyed, set as target or drawn.
+    TextureHandle texture;
+    // Size of a created texture.
+    int width;
+    int height;
+    SDL_Color color;
+    // Quads drawn: `RenderCapture::quads[firstQuad, +numQuads)`.
+    uint32_t firstQuad;
+    uint32_t numQuads;
+};
+
+/*
+ * Command stream captured by a `RecordingRenderDevice`. It holds the commands
+ * and quads, not texture pixels: see `replay`.
+ */
+struct RenderCapture {
+    std::vector<RenderCommand> commands;
+    std::vector<SpriteQuad> quads;
+
+    void clear() {
+      commands.clear();
+      quads.clear();
+    }
+
+    /**
+     * Replays the commands on `device`. Textures created during the capture
+     * are recreated as blank render targets of the same size and destroyed at
+     * the end; other handles are expected to be valid on `device`, e.g. when
+     * replaying on the device that was recorded.
+     */
+    void replay(RenderDevice& device) const;
+};
+
+/**
+ * `RenderDevice` that records the commands it receives into a `RenderCapture`
+ * and forwards them to another device, if any. Capture frames of the live
+ * renderer to replay them in benchmarks, or record without forwarding to
+ * inspect the command stream.
+ *
+ * Texture pixels are not recorded: a replay recreates the textures as blank
+ * render targets, so it reproduces the commands, draw calls and fill cost of
+ * the capture but not its image (checked by `make test-recording`).
+ */
+class RecordingRenderDevice : public RenderDevice {
+  private:
+    RenderDevice* m_target;
+    RenderCapture m_capture;
+    bool m_isRecording = true;
+    // Handles given out when there is no device to forward to.
+    TextureHandle m_nextHandle = 1;
+
+    void record(RenderCommandType type, TextureHandle texture);
+
+  public:
+    RecordingRenderDevice(RenderDevice* target = nullptr) : m_target(target) {}
+
+    void setRecording(bool isRecording) { m_isRecording = isRecording; }
+    const RenderCapture& getCapture() const { return m_capture; }
+    void clearCapture() { m_capture.clear(); }
+
+    TextureHandle createTexture(SDL_Surface* surface) override;
+    TextureHandle createRenderTarget(int width, int height) override;
+    void destroyTexture(TextureHandle texture) override;
+    void setRenderTarget(TextureHandle target) override;
+    void clear(SDL_Color color) override;
+    void drawQuads(TextureHandle texture, const SpriteQuad* quads,
+                   size_t count) override;
+    void present() override;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef RENDERDEVICE_HPP
+#define RENDERDEVICE_HPP
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Texture owned by a `RenderDevice`. NULL_TEXTURE is never a valid texture and
+ * stands for the screen when used as a render target.
+ */
+typedef uint32_t TextureHandle;
+const TextureHandle NULL_TEXTURE = 0;
+
+// Sprite quad as submitted to a device.
+struct SpriteQuad {
+    SDL_Rect srcRect;
+    SDL_FRect dstRect;
+    // Degrees, clockwise around the center of `dstRect`.
+    double rotation;
+    // Multiplies the texel colors and alpha, as SDL's color and alpha mod.
+    SDL_Color color = {255, 255, 255, 255};
+};
+
+// Bytes of texture memory filled from `surface` when creating a texture.
+inline uint64_t getSurfaceTextureSize(const SDL_Surface* surface) {
+  return static_cast<uint64_t>(surface->w) * surface->h *
+         surface->format->BytesPerPixel;
+}
+
+// Commands received by a `NullRenderDevice` or a `CountingRenderDevice`.
+struct RenderDeviceCounters {
+    uint64_t numTexturesCreated = 0;
+    uint64_t numTexturesDestroyed = 0;
+    uint64_t numTargetSwitches = 0;
+    uint64_t numClears = 0;
+    uint64_t numDrawCalls = 0;
+    // Draw calls sampling another texture than the previous one.
+    uint64_t numTextureSwitches = 0;
+    uint64_t numQuads = 0;
+    uint64_t numPresents = 0;
+    // Pixel data sent to the device by `createTexture`.
+    uint64_t numBytesUploaded = 0;
+    // Texture of the last draw call, every frame starts with a bind.
+    TextureHandle lastTexture = NULL_TEXTURE;
+
+    void countDraw(TextureHandle texture, size_t count) {
+      numDrawCalls++;
+      numQuads += count;
+      if (texture != lastTexture) {
+        numTextureSwitches++;
+        lastTexture = texture;
+      }
+    }
+
+    void countPresent() {
+      numPresents++;
+      lastTexture = NULL_TEXTURE;
+    }
+};
+
+/**
+ * Interface of the backends the renderer draws through (SDL, software, null,
+ * recording). It covers what the sprite renderer needs: textures, render
+ * targets, batched alpha-blended and color-modulated quads and present.
+ * Devices are used from the render thread only, except for texture creation
+ * while loading.
+ */
+class RenderDevice {
+  public:
+    virtual ~RenderDevice() = default;
+
+    // Creates a texture holding the surface pixels. The caller keeps the
+    // surface.
+    virtual TextureHandle createTexture(SDL_Surface* surface) = 0;
+
+    // Creates a transparent texture that can be drawn into.
+    virtual TextureHandle createRenderTarget(int width, int height) = 0;
+
+    virtual void destroyTexture(TextureHandle texture) = 0;
+
+    // Sends the next clears and draws to `target`, or to the screen.
+    virtual void setRenderTarget(TextureHandle target) = 0;
+
+    virtual void clear(SDL_Color color) = 0;
+
+    // Draws quads sampling the same texture, in order, alpha blended.
+    virtual void drawQuads(TextureHandle texture, const SpriteQuad* quads,
+                           size_t count) = 0;
+
+    // Shows the frame drawn to the screen.
+    virtual void present() = 0;
+};
+
+#endif
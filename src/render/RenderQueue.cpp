@@ -0,0 +1,82 @@
+#include "RenderQueue.hpp"
+
+void RenderQueue::sort() {
+  m_wasIncremental = tryIncrementalSort();
+  if (!m_wasIncremental) {
+    radixSort();
+  }
+}
+
+bool RenderQueue::tryIncrementalSort() {
+  const size_t numItems = m_items.size();
+  if (m_order.size() != numItems || numItems == 0) {
+    return false;
+  }
+
+  // refresh the keys in the previous frame's order and count descents
+  size_t numDescents = 0;
+  for (size_t i = 0; i < numItems; i++) {
+    m_order[i].key = m_items[m_order[i].index].sortKey;
+    if (i > 0 && m_order[i].key < m_order[i - 1].key) {
+      if (++numDescents > MAX_INCREMENTAL_DESCENTS) {
+        return false;
+      }
+    }
+  }
+
+  // the radix sort rebuilds from `m_items`: giving up midway is harmless
+  const size_t maxShifts = MAX_INCREMENTAL_SHIFTS_PER_ITEM * numItems;
+  size_t numShifts = 0;
+  for (size_t i = 1; i < numItems; i++) {
+    SortEntry entry = m_order[i];
+    size_t j = i;
+    while (j > 0 && m_order[j - 1].key > entry.key) {
+      if (++numShifts > maxShifts) {
+        return false;
+      }
+      m_order[j] = m_order[j - 1];
+      j--;
+    }
+    m_order[j] = entry;
+  }
+
+  return true;
+}
+
+void RenderQueue::radixSort() {
+  const size_t numItems = m_items.size();
+  m_order.resize(numItems);
+  m_scratch.resize(numItems);
+  for (size_t i = 0; i < numItems; i++) {
+    m_order[i] = {m_items[i].sortKey, static_cast<uint32_t>(i)};
+  }
+
+  // one histogram per byte, all filled in a single pass
+  uint32_t counts[8][256] = {};
+  for (const auto& entry : m_order) {
+    for (int byte = 0; byte < 8; byte++) {
+      counts[byte][(entry.key >> (byte * 8)) & 0xff]++;
+    }
+  }
+
+  for (int byte = 0; byte < 8; byte++) {
+    uint32_t* count = counts[byte];
+    const uint64_t firstDigit = numItems ? (m_order[0].key >> (byte * 8)) & 0xff
+                                         : 0;
+    if (count[firstDigit] == numItems) {
+      // every key has the same digit: the pass would not move anything
+      continue;
+    }
+
+    uint32_t offset = 0;
+    for (int digit = 0; digit < 256; digit++) {
+      const uint32_t digitCount = count[digit];
+      count[digit] = offset;
+      offset += digitCount;
+    }
+    for (const auto& entry : m_order) {
+      m_scratch[count[(entry.key >> (byte * 8)) & 0xff]++] = entry;
+    }
+    m_order.swap(m_scratch);
+  }
+}
@@ -0,0 +1,87 @@
+#ifndef RENDERQUEUE_HPP
+#define RENDERQUEUE_HPP
+#include "RenderDevice.hpp"
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Layout of the 64-bit sort keys, from most to least significant bits:
+ * layer (8) | depth (24) | texture (16) | material (16). Sorting by key draws
+ * lower layers first, then back-to-front inside a layer, and groups equal
+ * textures together so the sprite batch switches textures as little as
+ * possible.
+ */
+const uint32_t SORT_KEY_MAX_DEPTH = (1u << 24) - 1;
+
+inline uint64_t makeSortKey(uint8_t layer, uint32_t depth, uint16_t texture,
+                            uint16_t material = 0) {
+  return (static_cast<uint64_t>(layer) << 56) |
+         (static_cast<uint64_t>(depth & SORT_KEY_MAX_DEPTH) << 32) |
+         (static_cast<uint64_t>(texture) << 16) | material;
+}
+
+// One sprite quad waiting to be drawn.
+struct RenderItem {
+    uint64_t sortKey;
+    TextureHandle texture;
+    SDL_Rect srcRect;
+    SDL_FRect dstRect;
+    float rotation;
+    // Color modulation, e.g. the color of a text glyph.
+    SDL_Color color = {255, 255, 255, 255};
+};
+
+/**
+ * Per-frame list of render items sorted by their 64-bit key. Keys are sorted
+ * with an LSD radix sort (8-bit digits, passes whose digit is the same for
+ * every key are skipped), which is linear in the number of items. When the
+ * keys come in nearly in the order of the previous frame, the previous order
+ * is reused and fixed with an insertion sort instead.
+ */
+class RenderQueue {
+  private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<RenderItem> m_items;
+
+    // Sorted order of the items; the previous frame's order until `sort()`.
+    std::vector<SortEntry> m_order;
+    std::vector<SortEntry> m_scratch;
+
+    bool m_wasIncremental = false;
+
+    void radixSort();
+    bool tryIncrementalSort();
+
+  public:
+    // Most out-of-order neighbours tolerated before falling back to radix.
+    static const size_t MAX_INCREMENTAL_DESCENTS = 8;
+    /*
+     * Most item moves per item tolerated by the insertion sort: two swapped
+     * runs are one descent but cost quadratic moves, where radix is linear.
+     */
+    static const size_t MAX_INCREMENTAL_SHIFTS_PER_ITEM = 2;
+
+    void clear() { m_items.clear(); }
+    void push(const RenderItem& item) { m_items.push_back(item); }
+    size_t getSize() const { return m_items.size(); }
+
+    void sort();
+
+    // Whether the last `sort()` reused the previous order.
+    bool wasIncremental() const { return m_wasIncremental; }
+
+    // Calls `func(const RenderItem&)` for every item, in key order.
+    template <typename TFunc> void forEachSorted(TFunc&& func) const {
+      for (const auto& entry : m_order) {
+        func(m_items[entry.index]);
+      }
+    }
+};
+
+#endif
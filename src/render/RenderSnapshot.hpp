@@ -0,0 +1,92 @@
+#ifndef RENDERSNAPSHOT_HPP
+#define RENDERSNAPSHOT_HPP
+#include "RenderQueue.hpp"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Static chunk to (re)draw into its cached texture: `bakeItems[first, +num)`.
+struct StaticChunkBake {
+    uint64_t chunk;
+    uint32_t firstItem;
+    uint32_t numItems;
+};
+
+// Quad showing the cached texture of a static chunk.
+struct StaticChunkDraw {
+    uint64_t chunk;
+    uint64_t sortKey;
+    SDL_FRect dstRect;
+};
+
+// Screen position (top-left corner) and color of one particle quad.
+struct ParticleInstance {
+    float x;
+    float y;
+    SDL_Color color;
+};
+
+// Particles sharing a source rectangle and a size: `particles[first, +num)`.
+struct ParticleRun {
+    SDL_Rect srcRect;
+    float width;
+    float height;
+    uint32_t firstParticle;
+    uint32_t numParticles;
+};
+
+/*
+ * Particle runs of one texture and layer, drawn with a single device call:
+ * `particleRuns[firstRun, +numRuns)`. The sort key places the batch among the
+ * sprite items.
+ */
+struct ParticleBatch {
+    uint64_t sortKey;
+    TextureHandle texture;
+    uint32_t firstRun;
+    uint32_t numRuns;
+};
+
+/**
+ * Everything needed to draw one frame, written by the extract stage at the end
+ * of the simulation update (`RenderSystem::update`) and consumed by a
+ * `SnapshotRenderer`, possibly on another thread. It holds plain data only, so
+ * the renderer never touches the registry.
+ */
+struct RenderSnapshot {
+    SDL_Color clearColor;
+    // Sprite quads, in any order: the renderer sorts them by key.
+    std::vector<RenderItem> items;
+    std::vector<StaticChunkDraw> chunkDraws;
+    std::vector<StaticChunkBake> chunkBakes;
+    // Sorted quads of the chunks to bake, in chunk space.
+    std::vector<RenderItem> bakeItems;
+    // Chunks that became empty: their cached texture can be released.
+    std::vector<uint64_t> releasedChunks;
+    std::vector<ParticleBatch> particleBatches;
+    std::vector<ParticleRun> particleRuns;
+    std::vector<ParticleInstance> particles;
+    /*
+     * Draws the frame even if it equals the one on screen, e.g. after the
+     * window was exposed or resized.
+     */
+    bool isInvalidated = false;
+    // Entities culled by the extract stage, for the render statistics.
+    uint32_t numCulled = 0;
+
+    // Empties the snapshot, keeping the vectors' capacity.
+    void clear() {
+      items.clear();
+      chunkDraws.clear();
+      chunkBakes.clear();
+      bakeItems.clear();
+      releasedChunks.clear();
+      particleBatches.clear();
+      particleRuns.clear();
+      particles.clear();
+      isInvalidated = false;
+      numCulled = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "RenderStats.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+static double getStat(const RenderFrameStats& frame, RenderStat stat) {
+  switch (stat) {
+  case RENDER_STAT_DRAW_CALLS:
+    return frame.numDrawCalls;
+  case RENDER_STAT_TEXTURE_SWITCHES:
+    return frame.numTextureSwitches;
+  case RENDER_STAT_QUADS:
+    return frame.numQuads;
+  case RENDER_STAT_CULLED:
+    return frame.numCulled;
+  case RENDER_STAT_BYTES_UPLOADED:
+    return static_cast<double>(frame.numBytesUploaded);
+  }
+  return 0;
+}
+
+RenderStats::RenderStats(size_t capacity)
+    : m_frames(std::max<size_t>(capacity, 1)) {}
+
+void RenderStats::record(RenderFrameStats stats) {
+  stats.frame = m_numRecorded++;
+  m_frames[m_next] = stats;
+  m_next = (m_next + 1) % m_frames.size();
+  m_numFrames = std::min(m_numFrames + 1, m_frames.size());
+}
+
+const RenderFrameStats& RenderStats::getFrame(size_t i) const {
+  const size_t oldest = m_next + m_frames.size() - m_numFrames;
+  return m_frames[(oldest + i) % m_frames.size()];
+}
+
+RenderStatSummary RenderStats::summarize(RenderStat stat,
+                                         bool isPresentedOnly) const {
+  std::vector<double> values;
+  values.reserve(m_numFrames);
+  double sum = 0;
+  for (size_t i = 0; i < m_numFrames; i++) {
+    const RenderFrameStats& frame = getFrame(i);
+    if (isPresentedOnly && !frame.isPresented) {
+      continue;
+    }
+    values.push_back(getStat(frame, stat));
+    sum += values.back();
+  }
+  if (values.empty()) {
+    return {0, 0, 0, 0, 0};
+  }
+
+  const auto bounds = std::minmax_element(values.begin(), values.end());
+  RenderStatSummary summary = {values.size(), *bounds.first,
+                               sum / values.size(), *bounds.second, 0};
+
+  const size_t rank = static_cast<size_t>(std::ceil(0.99 * values.size())) - 1;
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  summary.p99 = values[rank];
+  return summary;
+}
+
+bool RenderStats::writeCsv(const std::string& filePath) const {
+  std::ofstream file(filePath);
+  if (!file) {
+    spdlog::error("[RenderStats] Failed to open {}", filePath);
+    return false;
+  }
+
+  file << "frame,presented,draw_calls,texture_switches,quads,culled,"
+          "bytes_uploaded\n";
+  for (size_t i = 0; i < m_numFrames; i++) {
+    const RenderFrameStats& frame = getFrame(i);
+    file << frame.frame << ',' << frame.isPresented << ','
+         << frame.numDrawCalls << ',' << frame.numTextureSwitches << ','
+         << frame.numQuads << ',' << frame.numCulled << ','
+         << frame.numBytesUploaded << '\n';
+  }
+  if (!file) {
+    spdlog::error("[RenderStats] Failed to write {}", filePath);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,83 @@
+#ifndef RENDERSTATS_HPP
+#define RENDERSTATS_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frames kept by default: 10 seconds at 60 frames per second.
+const size_t DEFAULT_RENDER_STATS_FRAMES = 600;
+
+// Work done by the renderer for one frame.
+struct RenderFrameStats {
+    // Index of the frame, counting every recorded frame.
+    uint64_t frame;
+    // Whether the frame was presented, rather than skipped as unchanged.
+    bool isPresented;
+    uint32_t numDrawCalls;
+    uint32_t numTextureSwitches;
+    uint32_t numQuads;
+    // Entities skipped by the extract stage because they were off-screen.
+    uint32_t numCulled;
+    uint64_t numBytesUploaded;
+};
+
+// Counter of `RenderFrameStats` a summary is computed over.
+enum RenderStat {
+  RENDER_STAT_DRAW_CALLS,
+  RENDER_STAT_TEXTURE_SWITCHES,
+  RENDER_STAT_QUADS,
+  RENDER_STAT_CULLED,
+  RENDER_STAT_BYTES_UPLOADED
+};
+
+struct RenderStatSummary {
+    // Frames summarized.
+    size_t numFrames;
+    double min;
+    double average;
+    double max;
+    // 99th percentile (nearest rank): 1% of the frames did more work.
+    double p99;
+};
+
+/**
+ * Statistics of the last frames rendered, in a ring buffer: recording a frame
+ * overwrites the oldest one and never allocates. Summaries are computed on
+ * demand over the frames kept.
+ */
+class RenderStats {
+  private:
+    std::vector<RenderFrameStats> m_frames;
+    // Slot the next frame is written to.
+    size_t m_next = 0;
+    size_t m_numFrames = 0;
+    uint64_t m_numRecorded = 0;
+
+  public:
+    RenderStats(size_t capacity = DEFAULT_RENDER_STATS_FRAMES);
+
+    // Adds a frame, overwriting the oldest one; sets its `frame` index.
+    void record(RenderFrameStats stats);
+
+    size_t getNumFrames() const { return m_numFrames; }
+
+    // Kept frame `i`, from 0 (oldest) to `getNumFrames() - 1` (latest).
+    const RenderFrameStats& getFrame(size_t i) const;
+
+    /**
+     * Summary of a counter over the kept frames; all zero if there are none.
+     * Only presented frames count by default: skipped frames draw nothing and
+     * would pull the minimum and average down.
+     */
+    RenderStatSummary summarize(RenderStat stat,
+                                bool isPresentedOnly = true) const;
+
+    /**
+     * Writes the kept frames to a CSV file, oldest first, with a header row.
+     * Returns false (and logs) if the file cannot be written.
+     */
+    bool writeCsv(const std::string& filePath) const;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "RenderThread.hpp"
+
+RenderThread::~RenderThread() { stop(); }
+
+void RenderThread::start() {
+  if (m_isRunning || !m_device) {
+    return;
+  }
+  m_isRunning = true;
+  m_thread = std::thread(&RenderThread::loop, this);
+}
+
+void RenderThread::stop() {
+  if (!m_isRunning) {
+    if (m_device) {
+      m_snapshotRenderer.releaseTextures(*m_device);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isRunning = false;
+  }
+  m_condition.notify_all();
+  m_thread.join();
+}
+
+void RenderThread::setCounters(const RenderDeviceCounters* counters) {
+  m_counters = counters;
+  if (counters) {
+    m_lastCounters = *counters;
+  }
+}
+
+RenderStats RenderThread::getStats() {
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  return m_stats;
+}
+
+void RenderThread::renderSnapshot(RenderSnapshot& snapshot) {
+  // read before rendering, which takes the snapshot content
+  const uint32_t numCulled = snapshot.numCulled;
+  m_snapshotRenderer.render(*m_device, snapshot);
+  const bool isPresented = m_snapshotRenderer.wasPresented();
+  m_isIdle.store(!isPresented, std::memory_order_relaxed);
+  if (!m_counters) {
+    return;
+  }
+
+  const RenderDeviceCounters& counters = *m_counters;
+  RenderFrameStats stats;
+  stats.isPresented = isPresented;
+  stats.numDrawCalls = static_cast<uint32_t>(counters.numDrawCalls -
+                                             m_lastCounters.numDrawCalls);
+  stats.numTextureSwitches = static_cast<uint32_t>(
+      counters.numTextureSwitches - m_lastCounters.numTextureSwitches);
+  stats.numQuads =
+      static_cast<uint32_t>(counters.numQuads - m_lastCounters.numQuads);
+  stats.numCulled = numCulled;
+  stats.numBytesUploaded =
+      counters.numBytesUploaded - m_lastCounters.numBytesUploaded;
+  m_lastCounters = counters;
+
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  m_stats.record(stats);
+}
+
+void RenderThread::publish() {
+  if (!m_isRunning) {
+    if (m_device) {
+      renderSnapshot(m_snapshots[m_writeIndex]);
+    }
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_hasPending && !m_isRendering; });
+    m_readIndex = m_writeIndex;
+    m_writeIndex = 1 - m_writeIndex;
+    m_hasPending = true;
+  }
+  m_condition.notify_all();
+}
+
+void RenderThread::runOnDevice(
+    const std::function<void(RenderDevice&)>& task) {
+  if (!m_isRunning) {
+    task(*m_device);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_deviceTask = &task;
+  m_condition.notify_all();
+  m_condition.wait(lock, [this] { return m_deviceTask == nullptr; });
+}
+
+void RenderThread::loop() {
+  for (;;) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] {
+      return m_hasPending || m_deviceTask || !m_isRunning;
+    });
+    if (m_deviceTask) {
+      const auto& task = *m_deviceTask;
+      lock.unlock();
+      task(*m_device);
+      lock.lock();
+      m_deviceTask = nullptr;
+      lock.unlock();
+      m_condition.notify_all();
+      continue;
+    }
+    if (!m_hasPending) {
+      break;
+    }
+    m_hasPending = false;
+    m_isRendering = true;
+    RenderSnapshot& snapshot = m_snapshots[m_readIndex];
+    lock.unlock();
+
+    renderSnapshot(snapshot);
+
+    lock.lock();
+    m_isRendering = false;
+    lock.unlock();
+    m_condition.notify_all();
+  }
+
+  // the chunk textures belong to the device, release them on its thread
+  m_snapshotRenderer.releaseTextures(*m_device);
+}
@@ -0,0 +1,109 @@
+#ifndef RENDERTHREAD_HPP
+#define RENDERTHREAD_HPP
+#include "RenderDevice.hpp"
+#include "RenderSnapshot.hpp"
+#include "RenderStats.hpp"
+#include "SnapshotRenderer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * Submits render snapshots on a dedicated thread that owns the render device,
+ * so simulating frame N+1 overlaps with drawing frame N.
+ *
+ * Snapshots are double-buffered: the game writes the back snapshot with
+ * `getWriteSnapshot()` and hands it over with `publish()`, which only waits if
+ * the render thread is still drawing the previous frame. No snapshot is ever
+ * dropped, since they may carry static chunk bakes.
+ *
+ * The device is created and used for loading on the main thread, then handed
+ * over by `start()`; the main thread must not touch it again until `stop()`.
+ * Without `start()`, `publish()` renders synchronously on the calling thread.
+ * Device work the game needs meanwhile, like creating textures, goes through
+ * `runOnDevice`.
+ *
+ * Platform limit: the device must tolerate being driven from a thread other
+ * than the one that created it. SDL only guarantees its renderers on the
+ * thread that created them, and the Metal and OpenGL backends on macOS fail
+ * otherwise, so the game starts the thread only when asked to (see
+ * `Game::isRenderThreaded`).
+ */
+class RenderThread {
+  private:
+    RenderDevice* m_device = nullptr;
+    SnapshotRenderer m_snapshotRenderer;
+
+    RenderSnapshot m_snapshots[2];
+    int m_writeIndex = 0;
+    int m_readIndex = 1;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_isRunning = false;
+    // A published snapshot is waiting for the render thread.
+    bool m_hasPending = false;
+    // The render thread is drawing `m_snapshots[m_readIndex]`.
+    bool m_isRendering = false;
+    // Task waiting to run on the render thread, see `runOnDevice`.
+    const std::function<void(RenderDevice&)>* m_deviceTask = nullptr;
+    // The last drawn snapshot was skipped, the screen did not change.
+    std::atomic<bool> m_isIdle{false};
+
+    // Counters of the device, read after each frame to fill `m_stats`.
+    const RenderDeviceCounters* m_counters = nullptr;
+    RenderDeviceCounters m_lastCounters;
+    RenderStats m_stats;
+    std::mutex m_statsMutex;
+
+    void loop();
+    void renderSnapshot(RenderSnapshot& snapshot);
+
+  public:
+    ~RenderThread();
+
+    void setDevice(RenderDevice* device) { m_device = device; }
+
+    /**
+     * Records the statistics of every frame from now on, from the counters
+     * the device updates (see `CountingRenderDevice`).
+     */
+    void setCounters(const RenderDeviceCounters* counters);
+
+    // Hands the device over to a new render thread.
+    void start();
+
+    // Draws the last published snapshot, then joins the render thread.
+    void stop();
+
+    bool isRunning() const { return m_isRunning; }
+
+    // Back snapshot, filled by the extract stage of the current frame.
+    RenderSnapshot& getWriteSnapshot() { return m_snapshots[m_writeIndex]; }
+
+    // Hands the back snapshot to the render thread and swaps the buffers.
+    void publish();
+
+    /**
+     * Runs `task` with the device on the thread that owns it and returns once
+     * it ran: on the render thread, between two frames, once it is started;
+     * on the calling thread otherwise. Call it from the main thread only. It
+     * waits for the frame being drawn, so batch the work.
+     */
+    void runOnDevice(const std::function<void(RenderDevice&)>& task);
+
+    /**
+     * Whether the last snapshot showed the frame already on screen, so it
+     * was not presented. Presenting waits for vsync, skipping does not: the
+     * game loop has to pace itself while idle.
+     */
+    bool isIdle() const { return m_isIdle.load(std::memory_order_relaxed); }
+
+    // Copy of the statistics of the last frames, safe from any thread.
+    RenderStats getStats();
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "SdlRenderDevice.hpp"
+#include "spdlog/spdlog.h"
+#include <cmath>
+
+SdlRenderDevice::SdlRenderDevice(SDL_Renderer* renderer) {
+  m_renderer = renderer;
+  m_textures.push_back({nullptr, 0, 0});
+}
+
+SdlRenderDevice::~SdlRenderDevice() {
+  for (auto& texture : m_textures) {
+    if (texture.texture) {
+      SDL_DestroyTexture(texture.texture);
+    }
+  }
+}
+
+TextureHandle SdlRenderDevice::addTexture(SDL_Texture* texture) {
+  if (!texture) {
+    spdlog::error("[SdlRenderDevice] Failed to create texture: {}",
+                  SDL_GetError());
+    return NULL_TEXTURE;
+  }
+
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  int width = 1;
+  int height = 1;
+  SDL_QueryTexture(texture, NULL, NULL, &width, &height);
+  const Texture entry = {texture, 1.0f / width, 1.0f / height};
+
+  if (!m_freeHandles.empty()) {
+    const TextureHandle handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+    m_textures[handle] = entry;
+    return handle;
+  }
+  m_textures.push_back(entry);
+  return static_cast<TextureHandle>(m_textures.size() - 1);
+}
+
+TextureHandle SdlRenderDevice::createTexture(SDL_Surface* surface) {
+  return addTexture(SDL_CreateTextureFromSurface(m_renderer, surface));
+}
+
+TextureHandle SdlRenderDevice::createRenderTarget(int width, int height) {
+  return addTexture(SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGBA8888,
+                                      SDL_TEXTUREACCESS_TARGET, width, height));
+}
+
+void SdlRenderDevice::destroyTexture(TextureHandle texture) {
+  if (texture == NULL_TEXTURE || texture >= m_textures.size() ||
+      !m_textures[texture].texture) {
+    return;
+  }
+  SDL_DestroyTexture(m_textures[texture].texture);
+  m_textures[texture].texture = nullptr;
+  m_freeHandles.push_back(texture);
+}
+
+void SdlRenderDevice::setRenderTarget(TextureHandle target) {
+  SDL_Texture* texture =
+      target == NULL_TEXTURE ? NULL : m_textures[target].texture;
+  SDL_SetRenderTarget(m_renderer, texture);
+}
+
+void SdlRenderDevice::clear(SDL_Color color) {
+  SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
+  SDL_RenderClear(m_renderer);
+}
+
+void SdlRenderDevice::drawQuads(TextureHandle texture, const SpriteQuad* quads,
+                                size_t count) {
+  const Texture& entry = m_textures[texture];
+  m_vertices.clear();
+  m_indices.clear();
+
+  for (size_t q = 0; q < count; q++) {
+    const SDL_Rect& srcRect = quads[q].srcRect;
+    const SDL_FRect& dstRect = quads[q].dstRect;
+    const float u0 = srcRect.x * entry.inverseWidth;
+    const float v0 = srcRect.y * entry.inverseHeight;
+    const float u1 = (srcRect.x + srcRect.w) * entry.inverseWidth;
+    const float v1 = (srcRect.y + srcRect.h) * entry.inverseHeight;
+
+    // corners in top-left, top-right, bottom-right, bottom-left order
+    SDL_FPoint corners[4];
+    if (quads[q].rotation == 0.0) {
+      const float x1 = dstRect.x + dstRect.w;
+      const float y1 = dstRect.y + dstRect.h;
+      corners[0] = {dstRect.x, dstRect.y};
+      corners[1] = {x1, dstRect.y};
+      corners[2] = {x1, y1};
+      corners[3] = {dstRect.x, y1};
+    } else {
+      const float radians =
+          static_cast<float>(quads[q].rotation * M_PI / 180.0);
+      const float cosine = std::cos(radians);
+      const float sine = std::sin(radians);
+      const float halfWidth = dstRect.w * 0.5f;
+      const float halfHeight = dstRect.h * 0.5f;
+      const float centerX = dstRect.x + halfWidth;
+      const float centerY = dstRect.y + halfHeight;
+      const float offsets[4][2] = {{-halfWidth, -halfHeight},
+                                   {halfWidth, -halfHeight},
+                                   {halfWidth, halfHeight},
+                                   {-halfWidth, halfHeight}};
+      for (int i = 0; i < 4; i++) {
+        corners[i] = {
+            centerX + offsets[i][0] * cosine - offsets[i][1] * sine,
+            centerY + offsets[i][0] * sine + offsets[i][1] * cosine};
+      }
+    }
+
+    const SDL_Color& color = quads[q].color;
+    const int base = static_cast<int>(m_vertices.size());
+    m_vertices.push_back({corners[0], color, {u0, v0}});
+    m_vertices.push_back({corners[1], color, {u1, v0}});
+    m_vertices.push_back({corners[2], color, {u1, v1}});
+    m_vertices.push_back({corners[3], color, {u0, v1}});
+
+    const int quadIndices[6] = {0, 1, 2, 2, 3, 0};
+    for (int index : quadIndices) {
+      m_indices.push_back(base + index);
+    }
+  }
+
+  SDL_RenderGeometry(m_renderer, entry.texture, m_vertices.data(),
+                     static_cast<int>(m_vertices.size()), m_indices.data(),
+                     static_cast<int>(m_indices.size()));
+}
+
+void SdlRenderDevice::present() { SDL_RenderPresent(m_renderer); }
@@ -0,0 +1,47 @@
+#ifndef SDLRENDERDEVICE_HPP
+#define SDLRENDERDEVICE_HPP
+#include "RenderDevice.hpp"
+#include <SDL2/SDL.h>
+#include <vector>
+
+/**
+ * `RenderDevice` on top of an `SDL_Renderer`. Each `drawQuads` call becomes a
+ * single `SDL_RenderGeometry` call; rotation and scale are applied on the CPU
+ * and unrotated quads skip the trigonometry.
+ */
+class SdlRenderDevice : public RenderDevice {
+  private:
+    struct Texture {
+        SDL_Texture* texture;
+        // Inverse texture size, to turn source pixels into UV coordinates.
+        float inverseWidth;
+        float inverseHeight;
+    };
+
+    SDL_Renderer* m_renderer;
+
+    // Textures by handle; slot 0 is NULL_TEXTURE.
+    std::vector<Texture> m_textures;
+    std::vector<TextureHandle> m_freeHandles;
+
+    // Reused between draw calls so their capacity is kept.
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+
+    TextureHandle addTexture(SDL_Texture* texture);
+
+  public:
+    SdlRenderDevice(SDL_Renderer* renderer);
+    ~SdlRenderDevice();
+
+    TextureHandle createTexture(SDL_Surface* surface) override;
+    TextureHandle createRenderTarget(int width, int height) override;
+    void destroyTexture(TextureHandle texture) override;
+    void setRenderTarget(TextureHandle target) override;
+    void clear(SDL_Color color) override;
+    void drawQuads(TextureHandle texture, const SpriteQuad* quads,
+                   size_t count) override;
+    void present() override;
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "SnapshotRenderer.hpp"
+#include "StaticLayerCache.hpp"
+#include <algorithm>
+#include <utility>
+
+static bool isSameRect(const SDL_Rect& a, const SDL_Rect& b) {
+  return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+static bool isSameRect(const SDL_FRect& a, const SDL_FRect& b) {
+  return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+static bool isSameColor(SDL_Color a, SDL_Color b) {
+  return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static bool isSameItem(const RenderItem& a, const RenderItem& b) {
+  return a.sortKey == b.sortKey && a.texture == b.texture &&
+         isSameRect(a.srcRect, b.srcRect) && isSameRect(a.dstRect, b.dstRect) &&
+         a.rotation == b.rotation && isSameColor(a.color, b.color);
+}
+
+static bool isSameChunkDraw(const StaticChunkDraw& a,
+                            const StaticChunkDraw& b) {
+  return a.chunk == b.chunk && a.sortKey == b.sortKey &&
+         isSameRect(a.dstRect, b.dstRect);
+}
+
+static bool isSameParticleBatch(const ParticleBatch& a,
+                                const ParticleBatch& b) {
+  return a.sortKey == b.sortKey && a.texture == b.texture &&
+         a.firstRun == b.firstRun && a.numRuns == b.numRuns;
+}
+
+static bool isSameParticleRun(const ParticleRun& a, const ParticleRun& b) {
+  return isSameRect(a.srcRect, b.srcRect) && a.width == b.width &&
+         a.height == b.height && a.firstParticle == b.firstParticle &&
+         a.numParticles == b.numParticles;
+}
+
+static bool isSameParticle(const ParticleInstance& a,
+                           const ParticleInstance& b) {
+  return a.x == b.x && a.y == b.y && isSameColor(a.color, b.color);
+}
+
+template <typename T, typename TEqual>
+static bool isSameVector(const std::vector<T>& a, const std::vector<T>& b,
+                         TEqual&& isSame) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (!isSame(a[i], b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether both snapshots draw the same image (chunk bakes aside).
+static bool isSameFrame(const RenderSnapshot& a, const RenderSnapshot& b) {
+  // cheapest and most likely to differ first
+  return isSameColor(a.clearColor, b.clearColor) &&
+         a.items.size() == b.items.size() &&
+         isSameVector(a.particles, b.particles, isSameParticle) &&
+         isSameVector(a.items, b.items, isSameItem) &&
+         isSameVector(a.chunkDraws, b.chunkDraws, isSameChunkDraw) &&
+         isSameVector(a.particleBatches, b.particleBatches,
+                      isSameParticleBatch) &&
+         isSameVector(a.particleRuns, b.particleRuns, isSameParticleRun);
+}
+
+void SnapshotRenderer::bakeChunks(RenderDevice& device,
+                                  const RenderSnapshot& snapshot) {
+  for (uint64_t chunk : snapshot.releasedChunks) {
+    auto texture = m_chunkTextures.find(chunk);
+    if (texture != m_chunkTextures.end()) {
+      device.destroyTexture(texture->second);
+      m_chunkTextures.erase(texture);
+    }
+  }
+
+  for (const auto& bake : snapshot.chunkBakes) {
+    TextureHandle& texture = m_chunkTextures[bake.chunk];
+    if (texture == NULL_TEXTURE) {
+      texture =
+          device.createRenderTarget(STATIC_CHUNK_SIZE, STATIC_CHUNK_SIZE);
+    }
+
+    device.setRenderTarget(texture);
+    device.clear({0, 0, 0, 0});
+    m_spriteBatch.begin();
+    for (uint32_t i = 0; i < bake.numItems; i++) {
+      const RenderItem& item = snapshot.bakeItems[bake.firstItem + i];
+      m_spriteBatch.draw(item.texture, item.srcRect, item.dstRect,
+                         item.rotation, item.color);
+    }
+    m_spriteBatch.end(device);
+    device.setRenderTarget(NULL_TEXTURE);
+  }
+}
+
+void SnapshotRenderer::drawParticles(RenderDevice& device,
+                                     const RenderSnapshot& snapshot,
+                                     const ParticleBatch& batch) {
+  size_t numQuads = 0;
+  for (uint32_t r = 0; r < batch.numRuns; r++) {
+    numQuads += snapshot.particleRuns[batch.firstRun + r].numParticles;
+  }
+  if (m_particleQuads.size() < numQuads) {
+    m_particleQuads.resize(numQuads);
+  }
+
+  SpriteQuad* quad = m_particleQuads.data();
+  for (uint32_t r = 0; r < batch.numRuns; r++) {
+    const ParticleRun& run = snapshot.particleRuns[batch.firstRun + r];
+    const ParticleInstance* particle = &snapshot.particles[run.firstParticle];
+    for (uint32_t i = 0; i < run.numParticles; i++, quad++, particle++) {
+      quad->srcRect = run.srcRect;
+      quad->dstRect = {particle->x, particle->y, run.width, run.height};
+      quad->rotation = 0;
+      quad->color = particle->color;
+    }
+  }
+  device.drawQuads(batch.texture, m_particleQuads.data(), numQuads);
+  m_numParticleDrawCalls++;
+}
+
+void SnapshotRenderer::render(RenderDevice& device,
+                              RenderSnapshot& snapshot) {
+  bakeChunks(device, snapshot);
+
+  // a bake changes the content of chunk textures even if the quads did not
+  if (m_hasPresented && !snapshot.isInvalidated &&
+      snapshot.chunkBakes.empty() && isSameFrame(snapshot, m_presented)) {
+    m_spriteBatch.begin();
+    m_numParticleDrawCalls = 0;
+    m_wasPresented = false;
+    m_numSkippedFrames++;
+    return;
+  }
+
+  m_renderQueue.clear();
+  for (const auto& item : snapshot.items) {
+    m_renderQueue.push(item);
+  }
+  for (const auto& draw : snapshot.chunkDraws) {
+    auto texture = m_chunkTextures.find(draw.chunk);
+    if (texture == m_chunkTextures.end()) {
+      continue;
+    }
+    m_renderQueue.push({draw.sortKey,
+                        texture->second,
+                        {0, 0, STATIC_CHUNK_SIZE, STATIC_CHUNK_SIZE},
+                        draw.dstRect,
+                        0});
+  }
+  m_renderQueue.sort();
+
+  const auto& particleBatches = snapshot.particleBatches;
+  m_particleOrder.clear();
+  for (uint32_t i = 0; i < particleBatches.size(); i++) {
+    m_particleOrder.push_back(i);
+  }
+  std::stable_sort(m_particleOrder.begin(), m_particleOrder.end(),
+                   [&](uint32_t a, uint32_t b) {
+                     return particleBatches[a].sortKey <
+                            particleBatches[b].sortKey;
+                   });
+  m_numParticleDrawCalls = 0;
+  size_t nextParticles = 0;
+  // particle batches go straight to the device, between the sprite batches
+  auto drawParticlesUntil = [&](uint64_t sortKey) {
+    if (nextParticles == m_particleOrder.size() ||
+        particleBatches[m_particleOrder[nextParticles]].sortKey > sortKey) {
+      return;
+    }
+    m_spriteBatch.flush(device);
+    while (nextParticles < m_particleOrder.size() &&
+           particleBatches[m_particleOrder[nextParticles]].sortKey <=
+               sortKey) {
+      drawParticles(device, snapshot,
+                    particleBatches[m_particleOrder[nextParticles++]]);
+    }
+  };
+
+  // draw background
+  device.clear(snapshot.clearColor);
+
+  m_spriteBatch.begin();
+  m_renderQueue.forEachSorted([&](const RenderItem& item) {
+    drawParticlesUntil(item.sortKey);
+    m_spriteBatch.draw(item.texture, item.srcRect, item.dstRect, item.rotation,
+                       item.color);
+  });
+  m_spriteBatch.end(device);
+  drawParticlesUntil(UINT64_MAX);
+
+  // render buffer
+  device.present();
+  std::swap(m_presented, snapshot);
+  m_hasPresented = true;
+  m_wasPresented = true;
+}
+
+void SnapshotRenderer::releaseTextures(RenderDevice& device) {
+  for (auto& texture : m_chunkTextures) {
+    device.destroyTexture(texture.second);
+  }
+  m_chunkTextures.clear();
+  m_hasPresented = false;
+}
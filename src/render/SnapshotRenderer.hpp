@@ -0,0 +1,77 @@
+#ifndef SNAPSHOTRENDERER_HPP
+#define SNAPSHOTRENDERER_HPP
+#include "RenderDevice.hpp"
+#include "RenderQueue.hpp"
+#include "RenderSnapshot.hpp"
+#include "SpriteBatch.hpp"
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Submits a `RenderSnapshot` to a `RenderDevice`: bakes the dirty static
+ * chunks into their render-target textures, sorts the quads by key, batches
+ * them, draws the particle batches in between and presents. It owns the
+ * static chunk textures, so it must always run on the thread that owns the
+ * device.
+ *
+ * A snapshot showing the same frame as the last presented one is not drawn:
+ * clear and present are skipped and the screen keeps the previous image.
+ * Comparing the snapshots stops at the first difference, so a changing frame
+ * costs little more than a few compares; an idle one costs reading it once.
+ */
+class SnapshotRenderer {
+  private:
+    RenderQueue m_renderQueue;
+    SpriteBatch m_spriteBatch;
+
+    // Cached static chunk textures, by chunk key.
+    std::unordered_map<uint64_t, TextureHandle> m_chunkTextures;
+
+    // Particle batches of the snapshot, in sort key order.
+    std::vector<uint32_t> m_particleOrder;
+    /*
+     * Quads of the particle batch being drawn. Only grows, so the quads are
+     * not initialized again every frame.
+     */
+    std::vector<SpriteQuad> m_particleQuads;
+    size_t m_numParticleDrawCalls = 0;
+
+    /*
+     * Content of the last presented snapshot, swapped out of the snapshot
+     * rather than copied. Only meaningful when `m_hasPresented`.
+     */
+    RenderSnapshot m_presented;
+    bool m_hasPresented = false;
+    bool m_wasPresented = false;
+    size_t m_numSkippedFrames = 0;
+
+    void bakeChunks(RenderDevice& device, const RenderSnapshot& snapshot);
+    void drawParticles(RenderDevice& device, const RenderSnapshot& snapshot,
+                       const ParticleBatch& batch);
+
+  public:
+    /**
+     * Draws and presents `snapshot`, unless it is the frame already on screen.
+     * Takes the content of a presented snapshot, leaving `snapshot` with an
+     * older frame: clear it before writing the next one.
+     */
+    void render(RenderDevice& device, RenderSnapshot& snapshot);
+
+    // Destroys the chunk textures. Call it before the device is destroyed.
+    void releaseTextures(RenderDevice& device);
+
+    // Whether the last `render()` presented, false if it skipped the frame.
+    bool wasPresented() const { return m_wasPresented; }
+
+    // Frames skipped because nothing changed on screen.
+    size_t getNumSkippedFrames() const { return m_numSkippedFrames; }
+
+    // Number of draw calls made by the last `render()`.
+    size_t getNumDrawCalls() const {
+      return m_spriteBatch.getNumDrawCalls() + m_numParticleDrawCalls;
+    }
+};
+
+#endif
@@ -0,0 +1,548 @@
+#include "SoftwareRasterizer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+// SSE2 when the compiler targets it, AVX2 through GCC/Clang target attributes
+#ifdef __SSE2__
+#define FLATLAND_RASTER_SSE2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define FLATLAND_RASTER_AVX2
+#endif
+#endif
+
+void SoftwareTexture::upload(const void* data, int pitch) {
+  const uint8_t* row = static_cast<const uint8_t*>(data);
+  for (int y = 0; y < height; y++) {
+    std::memcpy(&pixels[static_cast<size_t>(y) * width], row,
+                static_cast<size_t>(width) * sizeof(uint32_t));
+    row += pitch;
+  }
+}
+
+namespace {
+
+// Row of pixels to sample and blend: pixel i reads (s + i * dsdx, t + i * dtdx)
+struct Span {
+    const uint32_t* texels;
+    int textureWidth;
+    SDL_Rect srcRect;
+    float s;
+    float dsdx;
+    float t;
+    float dtdx;
+    // Color modulation, ARGB8888.
+    uint32_t color;
+};
+
+// x / 255, rounded down, for x in [0, 255 * 255].
+inline uint32_t div255(uint32_t x) { return (x + 1 + (x >> 8)) >> 8; }
+
+inline int clampTexel(float coordinate, int size) {
+  return std::min(std::max(static_cast<int>(coordinate * size), 0), size - 1);
+}
+
+inline uint32_t fetch(const Span& span, int i) {
+  const float s = span.s + span.dsdx * static_cast<float>(i);
+  const float t = span.t + span.dtdx * static_cast<float>(i);
+  const int u = span.srcRect.x + clampTexel(s, span.srcRect.w);
+  const int v = span.srcRect.y + clampTexel(t, span.srcRect.h);
+  return span.texels[static_cast<size_t>(v) * span.textureWidth + u];
+}
+
+// Color and alpha modulation: every channel becomes src * color / 255.
+inline uint32_t modulatePixel(uint32_t src, uint32_t color) {
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    result |= div255(((src >> shift) & 0xff) * ((color >> shift) & 0xff))
+              << shift;
+  }
+  return result;
+}
+
+/*
+ * SDL_BLENDMODE_BLEND as done by SDL's software blitters:
+ *   dstRGB = srcRGB * srcA / 255 + dstRGB * (255 - srcA) / 255
+ *   dstA = srcA + dstA * (255 - srcA) / 255
+ */
+inline uint32_t blendPixel(uint32_t src, uint32_t dst) {
+  const uint32_t alpha = src >> 24;
+  const uint32_t inverse = 255 - alpha;
+  uint32_t result = (alpha + div255((dst >> 24) * inverse)) << 24;
+  for (int shift = 0; shift < 24; shift += 8) {
+    const uint32_t channel = div255(((src >> shift) & 0xff) * alpha) +
+                             div255(((dst >> shift) & 0xff) * inverse);
+    result |= channel << shift;
+  }
+  return result;
+}
+
+void blendSpanScalar(const Span& span, uint32_t* dst, int count) {
+  for (int i = 0; i < count; i++) {
+    dst[i] = blendPixel(modulatePixel(fetch(span, i), span.color), dst[i]);
+  }
+}
+
+#ifdef FLATLAND_RASTER_SSE2
+
+// a * b / 255 per 16-bit lane, for a and b in [0, 255].
+inline __m128i mulDiv255(__m128i a, __m128i b) {
+  const __m128i product = _mm_mullo_epi16(a, b);
+  return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(product, _mm_set1_epi16(1)),
+                                      _mm_srli_epi16(product, 8)),
+                        8);
+}
+
+/*
+ * Modulates by `color` and blends 2 pixels unpacked to 16-bit lanes (B, G, R,
+ * A, B, G, R, A).
+ */
+inline __m128i blendLanes(__m128i src, __m128i dst, __m128i color) {
+  src = mulDiv255(src, color);
+  const __m128i alpha =
+      _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, 0xff), 0xff);
+  // colors are scaled by the source alpha, the alpha lane by 255 (unchanged)
+  const __m128i colorLanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+  const __m128i multiplier =
+      _mm_or_si128(_mm_and_si128(alpha, colorLanes),
+                   _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+  const __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+  return _mm_add_epi16(mulDiv255(src, multiplier), mulDiv255(dst, inverse));
+}
+
+inline __m128i blend4(__m128i src, __m128i dst, __m128i color) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i low = blendLanes(_mm_unpacklo_epi8(src, zero),
+                                 _mm_unpacklo_epi8(dst, zero), color);
+  const __m128i high = blendLanes(_mm_unpackhi_epi8(src, zero),
+                                  _mm_unpackhi_epi8(dst, zero), color);
+  return _mm_packus_epi16(low, high);
+}
+
+void blendSpanSse2(const Span& span, uint32_t* dst, int count) {
+  const __m128i color = _mm_unpacklo_epi8(
+      _mm_set1_epi32(static_cast<int>(span.color)), _mm_setzero_si128());
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128i src = _mm_setr_epi32(static_cast<int>(fetch(span, i)),
+                                       static_cast<int>(fetch(span, i + 1)),
+                                       static_cast<int>(fetch(span, i + 2)),
+                                       static_cast<int>(fetch(span, i + 3)));
+    __m128i* target = reinterpret_cast<__m128i*>(dst + i);
+    _mm_storeu_si128(target, blend4(src, _mm_loadu_si128(target), color));
+  }
+  for (; i < count; i++) {
+    dst[i] = blendPixel(modulatePixel(fetch(span, i), span.color), dst[i]);
+  }
+}
+
+#endif
+
+#ifdef FLATLAND_RASTER_AVX2
+
+__attribute__((target("avx2"))) inline __m256i mulDiv255x16(__m256i a,
+                                                            __m256i b) {
+  const __m256i product = _mm256_mullo_epi16(a, b);
+  return _mm256_srli_epi16(
+      _mm256_add_epi16(_mm256_add_epi16(product, _mm256_set1_epi16(1)),
+                       _mm256_srli_epi16(product, 8)),
+      8);
+}
+
+__attribute__((target("avx2"))) inline __m256i
+blendLanes8(__m256i src, __m256i dst, __m256i color) {
+  src = mulDiv255x16(src, color);
+  const __m256i alpha =
+      _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(src, 0xff), 0xff);
+  const __m256i multiplier = _mm256_or_si256(
+      _mm256_and_si256(alpha, _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0,
+                                               -1, -1, -1, 0, -1, -1, -1)),
+      _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0));
+  const __m256i inverse = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+  return _mm256_add_epi16(mulDiv255x16(src, multiplier),
+                          mulDiv255x16(dst, inverse));
+}
+
+// Texel coordinates and gathers are vectorized too: 8 pixels per iteration.
+__attribute__((target("avx2"))) void blendSpanAvx2(const Span& span,
+                                                   uint32_t* dst, int count) {
+  const __m256 offsets = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256 dsdx = _mm256_set1_ps(span.dsdx);
+  const __m256 dtdx = _mm256_set1_ps(span.dtdx);
+  const __m256 srcWidth = _mm256_set1_ps(static_cast<float>(span.srcRect.w));
+  const __m256 srcHeight = _mm256_set1_ps(static_cast<float>(span.srcRect.h));
+  const __m256i maxU = _mm256_set1_epi32(span.srcRect.w - 1);
+  const __m256i maxV = _mm256_set1_epi32(span.srcRect.h - 1);
+  const __m256i srcX = _mm256_set1_epi32(span.srcRect.x);
+  const __m256i srcY = _mm256_set1_epi32(span.srcRect.y);
+  const __m256i width = _mm256_set1_epi32(span.textureWidth);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i color = _mm256_unpacklo_epi8(
+      _mm256_set1_epi32(static_cast<int>(span.color)), zero);
+
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256 index =
+        _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), offsets);
+    const __m256 s =
+        _mm256_add_ps(_mm256_set1_ps(span.s), _mm256_mul_ps(dsdx, index));
+    const __m256 t =
+        _mm256_add_ps(_mm256_set1_ps(span.t), _mm256_mul_ps(dtdx, index));
+    __m256i u = _mm256_cvttps_epi32(_mm256_mul_ps(s, srcWidth));
+    __m256i v = _mm256_cvttps_epi32(_mm256_mul_ps(t, srcHeight));
+    u = _mm256_min_epi32(_mm256_max_epi32(u, zero), maxU);
+    v = _mm256_min_epi32(_mm256_max_epi32(v, zero), maxV);
+    const __m256i texel =
+        _mm256_add_epi32(_mm256_mullo_epi32(_mm256_add_epi32(v, srcY), width),
+                         _mm256_add_epi32(u, srcX));
+    const __m256i src = _mm256_i32gather_epi32(
+        reinterpret_cast<const int*>(span.texels), texel, 4);
+
+    __m256i* target = reinterpret_cast<__m256i*>(dst + i);
+    const __m256i destination = _mm256_loadu_si256(target);
+    const __m256i low =
+        blendLanes8(_mm256_unpacklo_epi8(src, zero),
+                    _mm256_unpacklo_epi8(destination, zero), color);
+    const __m256i high =
+        blendLanes8(_mm256_unpackhi_epi8(src, zero),
+                    _mm256_unpackhi_epi8(destination, zero), color);
+    _mm256_storeu_si256(target, _mm256_packus_epi16(low, high));
+  }
+  for (; i < count; i++) {
+    dst[i] = blendPixel(modulatePixel(fetch(span, i), span.color), dst[i]);
+  }
+}
+
+#endif
+
+/*
+ * Narrows [first, last) to the pixels x where v0 + dvdx * x is in [0, 1).
+ * Returns false if no pixel is left.
+ */
+bool clipSpan(double v0, double dvdx, int& first, int& last) {
+  if (dvdx == 0) {
+    return v0 >= 0 && v0 < 1 && first < last;
+  }
+  const double zeroAt = -v0 / dvdx;
+  const double oneAt = (1 - v0) / dvdx;
+  double low;
+  double high;
+  if (dvdx > 0) {
+    low = std::ceil(zeroAt);
+    high = std::ceil(oneAt);
+  } else {
+    low = std::floor(oneAt) + 1;
+    high = std::floor(zeroAt) + 1;
+  }
+  // clamp before converting: near-zero slopes put the bounds far out of range
+  low = std::max(low, static_cast<double>(first));
+  high = std::min(high, static_cast<double>(last));
+  if (!(low < high)) {
+    return false;
+  }
+  first = static_cast<int>(low);
+  last = static_cast<int>(high);
+  return true;
+}
+
+} // namespace
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height,
+                                       unsigned numThreads)
+    : m_framebuffer(width, height) {
+  m_target = &m_framebuffer;
+  m_nextTile.store(0);
+  m_numPixels.store(0);
+  m_blendPath = RASTER_BLEND_SCALAR;
+  if (!setBlendPath(RASTER_BLEND_AVX2)) {
+    setBlendPath(RASTER_BLEND_SSE2);
+  }
+
+  if (numThreads == 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (unsigned i = 1; i < numThreads; i++) {
+    m_workers.emplace_back(&SoftwareRasterizer::workerLoop, this);
+  }
+}
+
+SoftwareRasterizer::~SoftwareRasterizer() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopping = true;
+  }
+  m_startCondition.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void SoftwareRasterizer::resize(int width, int height) {
+  flush();
+  m_framebuffer = SoftwareTexture(width, height);
+}
+
+bool SoftwareRasterizer::setBlendPath(RasterBlendPath path) {
+  bool isSupported = path == RASTER_BLEND_SCALAR;
+#ifdef FLATLAND_RASTER_SSE2
+  if (path == RASTER_BLEND_SSE2) {
+    isSupported = SDL_HasSSE2() == SDL_TRUE;
+  }
+#endif
+#ifdef FLATLAND_RASTER_AVX2
+  if (path == RASTER_BLEND_AVX2) {
+    isSupported = SDL_HasAVX2() == SDL_TRUE;
+  }
+#endif
+  if (!isSupported) {
+    return false;
+  }
+  // the queued quads are drawn with the path they were queued with
+  flush();
+  m_blendPath = path;
+  return true;
+}
+
+void SoftwareRasterizer::setTarget(SoftwareTexture* target) {
+  flush();
+  m_target = target ? target : &m_framebuffer;
+}
+
+void SoftwareRasterizer::clear(SDL_Color color) {
+  flush();
+  const uint32_t pixel = (static_cast<uint32_t>(color.a) << 24) |
+                         (static_cast<uint32_t>(color.r) << 16) |
+                         (static_cast<uint32_t>(color.g) << 8) | color.b;
+  std::fill(m_target->pixels.begin(), m_target->pixels.end(), pixel);
+}
+
+void SoftwareRasterizer::drawQuad(const SoftwareTexture& texture,
+                                  const SDL_Rect& srcRect,
+                                  const SDL_FRect& dstRect, double rotation,
+                                  SDL_Color color) {
+  if (texture.pixels.empty() || srcRect.w <= 0 || srcRect.h <= 0) {
+    return;
+  }
+
+  // like SDL, the source is clipped to the texture and the destination with it
+  const int srcLeft = std::max(srcRect.x, 0);
+  const int srcTop = std::max(srcRect.y, 0);
+  const int srcRight = std::min(srcRect.x + srcRect.w, texture.width);
+  const int srcBottom = std::min(srcRect.y + srcRect.h, texture.height);
+  if (srcLeft >= srcRight || srcTop >= srcBottom) {
+    return;
+  }
+  SDL_FRect dst = dstRect;
+  if (srcLeft != srcRect.x || srcTop != srcRect.y ||
+      srcRight != srcRect.x + srcRect.w || srcBottom != srcRect.y + srcRect.h) {
+    const float scaleX = dstRect.w / srcRect.w;
+    const float scaleY = dstRect.h / srcRect.h;
+    dst = {dstRect.x + (srcLeft - srcRect.x) * scaleX,
+           dstRect.y + (srcTop - srcRect.y) * scaleY,
+           (srcRight - srcLeft) * scaleX, (srcBottom - srcTop) * scaleY};
+  }
+
+  // corners in top-left, top-right, bottom-right, bottom-left order
+  double corners[4][2];
+  const double halfWidth = dst.w * 0.5;
+  const double halfHeight = dst.h * 0.5;
+  const double centerX = dst.x + halfWidth;
+  const double centerY = dst.y + halfHeight;
+  const double radians = rotation * M_PI / 180.0;
+  const double cosine = rotation == 0.0 ? 1.0 : std::cos(radians);
+  const double sine = rotation == 0.0 ? 0.0 : std::sin(radians);
+  const double offsets[4][2] = {{-halfWidth, -halfHeight},
+                                {halfWidth, -halfHeight},
+                                {halfWidth, halfHeight},
+                                {-halfWidth, halfHeight}};
+  for (int i = 0; i < 4; i++) {
+    corners[i][0] = centerX + offsets[i][0] * cosine - offsets[i][1] * sine;
+    corners[i][1] = centerY + offsets[i][0] * sine + offsets[i][1] * cosine;
+  }
+  double minX = corners[0][0];
+  double minY = corners[0][1];
+  double maxX = corners[0][0];
+  double maxY = corners[0][1];
+  for (int i = 1; i < 4; i++) {
+    minX = std::min(minX, corners[i][0]);
+    minY = std::min(minY, corners[i][1]);
+    maxX = std::max(maxX, corners[i][0]);
+    maxY = std::max(maxY, corners[i][1]);
+  }
+
+  Quad quad;
+  quad.texture = &texture;
+  quad.srcRect = {srcLeft, srcTop, srcRight - srcLeft, srcBottom - srcTop};
+  quad.color = (static_cast<uint32_t>(color.a) << 24) |
+               (static_cast<uint32_t>(color.r) << 16) |
+               (static_cast<uint32_t>(color.g) << 8) | color.b;
+  quad.minX = static_cast<int>(std::max(std::floor(minX), 0.0));
+  quad.minY = static_cast<int>(std::max(std::floor(minY), 0.0));
+  quad.maxX = static_cast<int>(
+      std::min(std::ceil(maxX), static_cast<double>(m_target->width)));
+  quad.maxY = static_cast<int>(
+      std::min(std::ceil(maxY), static_cast<double>(m_target->height)));
+  if (quad.minX >= quad.maxX || quad.minY >= quad.maxY) {
+    return;
+  }
+
+  // invert p = c0 + s * (c1 - c0) + t * (c3 - c0)
+  const double ux = corners[1][0] - corners[0][0];
+  const double uy = corners[1][1] - corners[0][1];
+  const double vx = corners[3][0] - corners[0][0];
+  const double vy = corners[3][1] - corners[0][1];
+  const double determinant = ux * vy - uy * vx;
+  if (determinant == 0) {
+    return;
+  }
+  quad.dsdx = vy / determinant;
+  quad.dsdy = -vx / determinant;
+  quad.dtdx = -uy / determinant;
+  quad.dtdy = ux / determinant;
+  quad.s0 = -(corners[0][0] * quad.dsdx + corners[0][1] * quad.dsdy);
+  quad.t0 = -(corners[0][0] * quad.dtdx + corners[0][1] * quad.dtdy);
+  m_quads.push_back(quad);
+}
+
+void SoftwareRasterizer::binQuads() {
+  m_numTilesX = (m_target->width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+  m_numTilesY = (m_target->height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+  m_tileBins.resize(static_cast<size_t>(m_numTilesX) * m_numTilesY);
+  for (auto& bin : m_tileBins) {
+    bin.clear();
+  }
+
+  for (uint32_t i = 0; i < m_quads.size(); i++) {
+    const Quad& quad = m_quads[i];
+    const int lastTileX = (quad.maxX - 1) / RASTER_TILE_SIZE;
+    const int lastTileY = (quad.maxY - 1) / RASTER_TILE_SIZE;
+    for (int y = quad.minY / RASTER_TILE_SIZE; y <= lastTileY; y++) {
+      for (int x = quad.minX / RASTER_TILE_SIZE; x <= lastTileX; x++) {
+        m_tileBins[static_cast<size_t>(y) * m_numTilesX + x].push_back(i);
+      }
+    }
+  }
+}
+
+void SoftwareRasterizer::rasterizeQuad(const Quad& quad, int tileX,
+                                       int tileY) {
+  const int firstX = std::max(quad.minX, tileX * RASTER_TILE_SIZE);
+  const int lastX = std::min(quad.maxX, (tileX + 1) * RASTER_TILE_SIZE);
+  const int firstY = std::max(quad.minY, tileY * RASTER_TILE_SIZE);
+  const int lastY = std::min(quad.maxY, (tileY + 1) * RASTER_TILE_SIZE);
+
+  Span span;
+  span.texels = quad.texture->pixels.data();
+  span.textureWidth = quad.texture->width;
+  span.srcRect = quad.srcRect;
+  span.color = quad.color;
+  span.dsdx = static_cast<float>(quad.dsdx);
+  span.dtdx = static_cast<float>(quad.dtdx);
+
+  uint64_t numPixels = 0;
+  for (int y = firstY; y < lastY; y++) {
+    // coordinates at the center of pixel (0, y)
+    const double rowS = quad.s0 + quad.dsdy * (y + 0.5) + quad.dsdx * 0.5;
+    const double rowT = quad.t0 + quad.dtdy * (y + 0.5) + quad.dtdx * 0.5;
+    int first = firstX;
+    int last = lastX;
+    if (!clipSpan(rowS, quad.dsdx, first, last) ||
+        !clipSpan(rowT, quad.dtdx, first, last)) {
+      continue;
+    }
+
+    span.s = static_cast<float>(rowS + quad.dsdx * first);
+    span.t = static_cast<float>(rowT + quad.dtdx * first);
+    uint32_t* row =
+        &m_target->pixels[static_cast<size_t>(y) * m_target->width + first];
+    switch (m_blendPath) {
+#ifdef FLATLAND_RASTER_AVX2
+    case RASTER_BLEND_AVX2:
+      blendSpanAvx2(span, row, last - first);
+      break;
+#endif
+#ifdef FLATLAND_RASTER_SSE2
+    case RASTER_BLEND_SSE2:
+      blendSpanSse2(span, row, last - first);
+      break;
+#endif
+    default:
+      blendSpanScalar(span, row, last - first);
+      break;
+    }
+    numPixels += last - first;
+  }
+  m_numPixels.fetch_add(numPixels, std::memory_order_relaxed);
+}
+
+void SoftwareRasterizer::rasterizeTiles() {
+  const int numTiles = m_numTilesX * m_numTilesY;
+  for (;;) {
+    const int tile = m_nextTile.fetch_add(1);
+    if (tile >= numTiles) {
+      return;
+    }
+    for (uint32_t quad : m_tileBins[tile]) {
+      rasterizeQuad(m_quads[quad], tile % m_numTilesX, tile / m_numTilesX);
+    }
+  }
+}
+
+void SoftwareRasterizer::workerLoop() {
+  uint64_t generation = 0;
+  for (;;) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_startCondition.wait(
+        lock, [&] { return m_generation != generation || m_isStopping; });
+    if (m_isStopping) {
+      return;
+    }
+    generation = m_generation;
+    lock.unlock();
+
+    rasterizeTiles();
+
+    lock.lock();
+    if (--m_numBusyWorkers == 0) {
+      m_doneCondition.notify_one();
+    }
+  }
+}
+
+void SoftwareRasterizer::flush() {
+  if (m_quads.empty()) {
+    return;
+  }
+  const auto start = std::chrono::steady_clock::now();
+
+  binQuads();
+  m_nextTile.store(0);
+  if (!m_workers.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_generation++;
+      m_numBusyWorkers = m_workers.size();
+    }
+    m_startCondition.notify_all();
+  }
+
+  // the calling thread takes tiles too
+  rasterizeTiles();
+
+  if (!m_workers.empty()) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_numBusyWorkers == 0; });
+  }
+  m_quads.clear();
+
+  m_rasterSeconds += std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+}
+
+void SoftwareRasterizer::resetStats() {
+  m_numPixels.store(0);
+  m_rasterSeconds = 0;
+}
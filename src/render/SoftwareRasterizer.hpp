@@ -0,0 +1,144 @@
+#ifndef SOFTWARERASTERIZER_HPP
+#define SOFTWARERASTERIZER_HPP
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Side, in pixels, of the square tiles quads are binned into.
+const int RASTER_TILE_SIZE = 64;
+
+// Code paths blending the pixels, see `SoftwareRasterizer::setBlendPath`.
+enum RasterBlendPath {
+  RASTER_BLEND_SCALAR,
+  RASTER_BLEND_SSE2,
+  RASTER_BLEND_AVX2
+};
+
+/*
+ * Image in CPU memory, in SDL_PIXELFORMAT_ARGB8888 with straight (not
+ * premultiplied) alpha. Used both as a sprite source and as a render target.
+ */
+struct SoftwareTexture {
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+
+    SoftwareTexture(int width = 0, int height = 0) {
+      this->width = width;
+      this->height = height;
+      this->pixels.assign(static_cast<size_t>(width) * height, 0);
+    }
+
+    // Copies ARGB8888 rows of `width` pixels, `pitch` bytes apart.
+    void upload(const void* data, int pitch);
+};
+
+/**
+ * CPU render backend for the sprite quads `RenderSystem` produces: textured,
+ * scaled, rotated and alpha-blended, into a `SoftwareTexture`. It needs no GPU,
+ * for headless benchmarks and servers capturing thumbnails.
+ *
+ * Quads are queued by `drawQuad` and binned by screen tile; `flush` then
+ * rasterizes the tiles on a pool of worker threads. Each tile is owned by one
+ * thread and draws its quads in submission order, so the output does not
+ * depend on the number of threads. Sampling is nearest-neighbour; color
+ * modulation and blending follow SDL_BLENDMODE_BLEND with SDL's integer
+ * rounding, to match SDL's software renderer. Blending runs 4 (SSE2) or 8
+ * (AVX2, when the CPU has it) pixels at a time.
+ */
+class SoftwareRasterizer {
+  private:
+    /*
+     * Quad mapped to normalized source coordinates (s, t) in [0, 1)^2, which
+     * are affine in screen space: s = s0 + dsdx * x + dsdy * y, same for t.
+     */
+    struct Quad {
+        const SoftwareTexture* texture;
+        SDL_Rect srcRect;
+        // Color modulation, packed like the pixels.
+        uint32_t color;
+        double s0, dsdx, dsdy;
+        double t0, dtdx, dtdy;
+        // Screen bounds, clipped to the target, max exclusive.
+        int minX, minY, maxX, maxY;
+    };
+
+    SoftwareTexture m_framebuffer;
+    SoftwareTexture* m_target;
+
+    std::vector<Quad> m_quads;
+    // Indices of the quads overlapping each tile, in submission order.
+    std::vector<std::vector<uint32_t>> m_tileBins;
+    int m_numTilesX = 0;
+    int m_numTilesY = 0;
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_startCondition;
+    std::condition_variable m_doneCondition;
+    uint64_t m_generation = 0;
+    size_t m_numBusyWorkers = 0;
+    bool m_isStopping = false;
+    std::atomic<int> m_nextTile;
+
+    RasterBlendPath m_blendPath;
+    std::atomic<uint64_t> m_numPixels;
+    double m_rasterSeconds = 0;
+
+    void workerLoop();
+    void rasterizeTiles();
+    void rasterizeQuad(const Quad& quad, int tileX, int tileY);
+    void binQuads();
+
+  public:
+    /**
+     * `numThreads` counts the calling thread, which also rasterizes during
+     * `flush`; 0 uses one thread per core.
+     */
+    SoftwareRasterizer(int width, int height, unsigned numThreads = 0);
+    ~SoftwareRasterizer();
+
+    // Resizes the framebuffer, dropping its content.
+    void resize(int width, int height);
+
+    // Target of the next draws, or the framebuffer if `target` is null.
+    void setTarget(SoftwareTexture* target);
+
+    // Fills the target with `color`, after flushing the queued quads.
+    void clear(SDL_Color color);
+
+    /**
+     * Queues a sprite quad, with the same conventions as `SpriteBatch::draw`:
+     * `rotation` is in degrees, clockwise around the center of `dstRect`.
+     * Texels are multiplied by `color` before blending, as SDL's color mod.
+     */
+    void drawQuad(const SoftwareTexture& texture, const SDL_Rect& srcRect,
+                  const SDL_FRect& dstRect, double rotation,
+                  SDL_Color color = {255, 255, 255, 255});
+
+    // Rasterizes the queued quads into the target.
+    void flush();
+
+    const SoftwareTexture& getFramebuffer() const { return m_framebuffer; }
+
+    /**
+     * Forces a blending code path, e.g. to check that they draw the same
+     * pixels. Returns false, leaving the path unchanged, if the CPU or the
+     * build does not support it. The fastest one is used by default.
+     */
+    bool setBlendPath(RasterBlendPath path);
+    RasterBlendPath getBlendPath() const { return m_blendPath; }
+
+    // Pixels blended and time spent rasterizing since the last reset.
+    uint64_t getNumPixels() const { return m_numPixels.load(); }
+    double getPixelsPerSecond() const {
+      return m_rasterSeconds > 0 ? m_numPixels.load() / m_rasterSeconds : 0;
+    }
+    void resetStats();
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "SoftwareRenderDevice.hpp"
+#include "spdlog/spdlog.h"
+#include <fstream>
+
+SoftwareRenderDevice::SoftwareRenderDevice(int width, int height,
+                                           unsigned numThreads)
+    : m_rasterizer(width, height, numThreads) {
+  m_textures.emplace_back();
+}
+
+TextureHandle
+SoftwareRenderDevice::addTexture(std::unique_ptr<SoftwareTexture> texture) {
+  if (!m_freeHandles.empty()) {
+    const TextureHandle handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+    m_textures[handle] = std::move(texture);
+    return handle;
+  }
+  m_textures.push_back(std::move(texture));
+  return static_cast<TextureHandle>(m_textures.size() - 1);
+}
+
+TextureHandle SoftwareRenderDevice::createTexture(SDL_Surface* surface) {
+  SDL_Surface* converted =
+      SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+  if (!converted) {
+    spdlog::error("[SoftwareRenderDevice] Failed to convert surface: {}",
+                  SDL_GetError());
+    return NULL_TEXTURE;
+  }
+
+  auto texture = std::make_unique<SoftwareTexture>(converted->w, converted->h);
+  SDL_LockSurface(converted);
+  texture->upload(converted->pixels, converted->pitch);
+  SDL_UnlockSurface(converted);
+  SDL_FreeSurface(converted);
+  return addTexture(std::move(texture));
+}
+
+TextureHandle SoftwareRenderDevice::createRenderTarget(int width, int height) {
+  return addTexture(std::make_unique<SoftwareTexture>(width, height));
+}
+
+void SoftwareRenderDevice::destroyTexture(TextureHandle texture) {
+  if (texture == NULL_TEXTURE || texture >= m_textures.size() ||
+      !m_textures[texture]) {
+    return;
+  }
+  // queued quads may still sample it
+  m_rasterizer.flush();
+  m_textures[texture].reset();
+  m_freeHandles.push_back(texture);
+}
+
+void SoftwareRenderDevice::setRenderTarget(TextureHandle target) {
+  m_rasterizer.setTarget(target < m_textures.size() ? m_textures[target].get()
+                                                    : nullptr);
+}
+
+void SoftwareRenderDevice::clear(SDL_Color color) { m_rasterizer.clear(color); }
+
+void SoftwareRenderDevice::drawQuads(TextureHandle texture,
+                                     const SpriteQuad* quads, size_t count) {
+  // NULL_TEXTURE or destroyed: nothing to sample
+  if (texture >= m_textures.size() || !m_textures[texture]) {
+    return;
+  }
+  const SoftwareTexture& source = *m_textures[texture];
+  for (size_t i = 0; i < count; i++) {
+    m_rasterizer.drawQuad(source, quads[i].srcRect, quads[i].dstRect,
+                          quads[i].rotation, quads[i].color);
+  }
+}
+
+void SoftwareRenderDevice::present() { m_rasterizer.flush(); }
+
+bool SoftwareRenderDevice::saveFramebuffer(const std::string& filePath) const {
+  const SoftwareTexture& framebuffer = m_rasterizer.getFramebuffer();
+  std::ofstream file(filePath, std::ios::binary);
+  if (!file) {
+    spdlog::error("[SoftwareRenderDevice] Failed to open {}", filePath);
+    return false;
+  }
+
+  // binary PPM: RGB bytes, alpha dropped
+  file << "P6\n" << framebuffer.width << " " << framebuffer.height << "\n255\n";
+  std::vector<uint8_t> row(static_cast<size_t>(framebuffer.width) * 3);
+  for (int y = 0; y < framebuffer.height; y++) {
+    const uint32_t* pixels =
+        &framebuffer.pixels[static_cast<size_t>(y) * framebuffer.width];
+    for (int x = 0; x < framebuffer.width; x++) {
+      row[x * 3] = static_cast<uint8_t>(pixels[x] >> 16);
+      row[x * 3 + 1] = static_cast<uint8_t>(pixels[x] >> 8);
+      row[x * 3 + 2] = static_cast<uint8_t>(pixels[x]);
+    }
+    file.write(reinterpret_cast<const char*>(row.data()), row.size());
+  }
+  if (!file) {
+    spdlog::error("[SoftwareRenderDevice] Failed to write {}", filePath);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,47 @@
+#ifndef SOFTWARERENDERDEVICE_HPP
+#define SOFTWARERENDERDEVICE_HPP
+#include "RenderDevice.hpp"
+#include "SoftwareRasterizer.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * `RenderDevice` drawing on the CPU with a `SoftwareRasterizer`, for headless
+ * rendering. Frames end up in `getFramebuffer()` when presented.
+ */
+class SoftwareRenderDevice : public RenderDevice {
+  private:
+    SoftwareRasterizer m_rasterizer;
+
+    // Textures by handle; slot 0 is NULL_TEXTURE.
+    std::vector<std::unique_ptr<SoftwareTexture>> m_textures;
+    std::vector<TextureHandle> m_freeHandles;
+
+    TextureHandle addTexture(std::unique_ptr<SoftwareTexture> texture);
+
+  public:
+    SoftwareRenderDevice(int width, int height, unsigned numThreads = 0);
+
+    TextureHandle createTexture(SDL_Surface* surface) override;
+    TextureHandle createRenderTarget(int width, int height) override;
+    void destroyTexture(TextureHandle texture) override;
+    void setRenderTarget(TextureHandle target) override;
+    void clear(SDL_Color color) override;
+    void drawQuads(TextureHandle texture, const SpriteQuad* quads,
+                   size_t count) override;
+    void present() override;
+
+    const SoftwareTexture& getFramebuffer() const {
+      return m_rasterizer.getFramebuffer();
+    }
+    SoftwareRasterizer& getRasterizer() { return m_rasterizer; }
+
+    /**
+     * Writes the last presented frame to `filePath` as a binary PPM image.
+     * Returns false (and logs) if the file cannot be written.
+     */
+    bool saveFramebuffer(const std::string& filePath) const;
+};
+
+#endif
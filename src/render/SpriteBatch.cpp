@@ -0,0 +1,47 @@
+#include "SpriteBatch.hpp"
+
+void SpriteBatch::clearBatches() {
+  for (size_t i = 0; i < m_numBatches; i++) {
+    m_batches[i].quads.clear();
+  }
+  m_numBatches = 0;
+}
+
+void SpriteBatch::begin() {
+  clearBatches();
+  m_numDrawCalls = 0;
+}
+
+SpriteBatch::Batch& SpriteBatch::getBatch(TextureHandle texture) {
+  if (m_numBatches > 0 && m_batches[m_numBatches - 1].texture == texture) {
+    return m_batches[m_numBatches - 1];
+  }
+
+  if (m_numBatches == m_batches.size()) {
+    m_batches.emplace_back();
+  }
+  Batch& batch = m_batches[m_numBatches++];
+  batch.texture = texture;
+
+  return batch;
+}
+
+void SpriteBatch::draw(TextureHandle texture, const SDL_Rect& srcRect,
+                       const SDL_FRect& dstRect, double rotation,
+                       SDL_Color color) {
+  getBatch(texture).quads.push_back({srcRect, dstRect, rotation, color});
+}
+
+void SpriteBatch::flush(RenderDevice& device) {
+  for (size_t i = 0; i < m_numBatches; i++) {
+    const Batch& batch = m_batches[i];
+    if (batch.quads.empty()) {
+      continue;
+    }
+    device.drawQuads(batch.texture, batch.quads.data(), batch.quads.size());
+    m_numDrawCalls++;
+  }
+  clearBatches();
+}
+
+void SpriteBatch::end(RenderDevice& device) { flush(device); }
@@ -0,0 +1,60 @@
+#ifndef SPRITEBATCH_HPP
+#define SPRITEBATCH_HPP
+#include "RenderDevice.hpp"
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Collects textured quads during a frame and submits them with one
+ * `RenderDevice::drawQuads` call per texture instead of one call per sprite.
+ *
+ * Draw order is kept: consecutive quads sharing a texture form one batch, and
+ * a texture change starts a new one. Submit quads sorted by texture (see
+ * `RenderQueue`) to get the fewest batches.
+ */
+class SpriteBatch {
+  private:
+    struct Batch {
+        TextureHandle texture;
+        std::vector<SpriteQuad> quads;
+    };
+
+    /*
+     * Batches of the current frame are `m_batches[0, m_numBatches)`. The
+     * vectors are kept between frames so their capacity is reused.
+     */
+    std::vector<Batch> m_batches;
+    size_t m_numBatches = 0;
+    size_t m_numDrawCalls = 0;
+
+    Batch& getBatch(TextureHandle texture);
+    void clearBatches();
+
+  public:
+    // Starts a new frame, dropping the quads of the previous one.
+    void begin();
+
+    /**
+     * Adds a sprite quad. `rotation` is in degrees, clockwise around the center
+     * of `dstRect`, as in `SDL_RenderCopyEx`. The texels are multiplied by
+     * `color`.
+     */
+    void draw(TextureHandle texture, const SDL_Rect& srcRect,
+              const SDL_FRect& dstRect, double rotation,
+              SDL_Color color = {255, 255, 255, 255});
+
+    /**
+     * Submits the batches collected so far, one draw call per batch, so that
+     * quads drawn directly on the device afterwards end up on top.
+     */
+    void flush(RenderDevice& device);
+
+    // Submits every batch to the device, one draw call per batch.
+    void end(RenderDevice& device);
+
+    // Number of `drawQuads` calls made since the last `begin()`.
+    size_t getNumDrawCalls() const { return m_numDrawCalls; }
+};
+
+#endif
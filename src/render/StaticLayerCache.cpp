@@ -0,0 +1,248 @@
+#include "StaticLayerCache.hpp"
+#include <algorithm>
+#include <cmath>
+
+uint64_t StaticLayerCache::getChunkKey(uint8_t layer, int x, int y) {
+  return (static_cast<uint64_t>(layer) << 48) |
+         (static_cast<uint64_t>(x & 0xffffff) << 24) |
+         static_cast<uint64_t>(y & 0xffffff);
+}
+
+void StaticLayerCache::insert(Entity entity) {
+  // both trackers insert each sprite, e.g. when they backfill a registry
+  erase(entity);
+
+  const auto& transform = entity.getComponent<TransformComponent>();
+  const auto& sprite = entity.getComponent<SpriteComponent>();
+
+  // world bounds; rotated sprites are bounded by their circumcircle
+  const float width = sprite.width * transform.scale.x;
+  const float height = sprite.height * transform.scale.y;
+  float left = transform.position.x;
+  float top = transform.position.y;
+  float right = left + width;
+  float bottom = top + height;
+  if (transform.rotation != 0.0) {
+    const float radius = 0.5f * std::hypot(width, height);
+    const float centerX = left + 0.5f * width;
+    const float centerY = top + 0.5f * height;
+    left = centerX - radius;
+    top = centerY - radius;
+    right = centerX + radius;
+    bottom = centerY + radius;
+  }
+
+  const uint16_t entityId = entity.getId();
+  if (entityId >= m_entityChunks.size()) {
+    m_entityChunks.resize(entityId + 1);
+  }
+
+  const int firstX = static_cast<int>(std::floor(left / STATIC_CHUNK_SIZE));
+  const int firstY = static_cast<int>(std::floor(top / STATIC_CHUNK_SIZE));
+  const int lastX = static_cast<int>(std::ceil(right / STATIC_CHUNK_SIZE)) - 1;
+  const int lastY = static_cast<int>(std::ceil(bottom / STATIC_CHUNK_SIZE)) - 1;
+  for (int y = firstY; y <= lastY; y++) {
+    for (int x = firstX; x <= lastX; x++) {
+      const uint64_t key = getChunkKey(sprite.zIndex, x, y);
+      Chunk& chunk = m_chunks[key];
+      chunk.layer = sprite.zIndex;
+      chunk.x = x;
+      chunk.y = y;
+      chunk.entities.push_back(entity);
+      chunk.isDirty = true;
+      m_entityChunks[entityId].push_back(key);
+    }
+  }
+  m_layers.set(sprite.zIndex);
+}
+
+void StaticLayerCache::erase(Entity entity) {
+  const uint16_t entityId = entity.getId();
+  if (entityId >= m_entityChunks.size()) {
+    return;
+  }
+
+  for (uint64_t key : m_entityChunks[entityId]) {
+    Chunk& chunk = m_chunks[key];
+    for (auto e = chunk.entities.begin(); e != chunk.entities.end(); ++e) {
+      if (e->getId() == entityId) {
+        chunk.entities.erase(e);
+        break;
+      }
+    }
+    chunk.isDirty = true;
+  }
+  m_entityChunks[entityId].clear();
+}
+
+void StaticLayerCache::invalidateAll() {
+  for (auto& chunk : m_chunks) {
+    chunk.second.isDirty = true;
+  }
+}
+
+void StaticLayerCache::setDynamicLayers(const std::bitset<256>& layers) {
+  const std::bitset<256> changed = layers ^ m_dynamicLayers;
+  if (changed.none()) {
+    return;
+  }
+  for (auto& chunk : m_chunks) {
+    if (changed.test(chunk.second.layer) && !chunk.second.entities.empty()) {
+      chunk.second.isDirty = true;
+    }
+  }
+  m_dynamicLayers = layers;
+}
+
+void StaticLayerCache::syncTilemap(const Tilemap* tilemap, uint8_t layer) {
+  if (tilemap == m_tilemap && layer == m_tilemapLayer &&
+      (!tilemap || tilemap->getVersion() == m_tilemapVersion)) {
+    return;
+  }
+
+  for (auto& chunk : m_chunks) {
+    if (chunk.second.hasTiles) {
+      chunk.second.hasTiles = false;
+      chunk.second.isDirty = true;
+    }
+  }
+  m_tilemap = tilemap;
+  m_tilemapLayer = layer;
+  if (!tilemap) {
+    return;
+  }
+  m_tilemapVersion = tilemap->getVersion();
+
+  const float mapWidth = tilemap->getWidth() * tilemap->getTileWorldSize();
+  const float mapHeight = tilemap->getHeight() * tilemap->getTileWorldSize();
+  const int lastX =
+      static_cast<int>(std::ceil(mapWidth / STATIC_CHUNK_SIZE)) - 1;
+  const int lastY =
+      static_cast<int>(std::ceil(mapHeight / STATIC_CHUNK_SIZE)) - 1;
+  for (int y = 0; y <= lastY; y++) {
+    for (int x = 0; x <= lastX; x++) {
+      Chunk& chunk = m_chunks[getChunkKey(layer, x, y)];
+      chunk.layer = layer;
+      chunk.x = x;
+      chunk.y = y;
+      chunk.hasTiles = true;
+      chunk.isDirty = true;
+    }
+  }
+  m_layers.set(layer);
+}
+
+bool StaticLayerCache::extractBake(uint64_t key, const Chunk& chunk,
+                                   AssetStore& assetStore,
+                                   RenderSnapshot& snapshot) {
+  if (isEmpty(chunk)) {
+    snapshot.releasedChunks.push_back(key);
+    return true;
+  }
+  // a baked chunk is not redrawn, so it waits for all of its textures
+  if (chunk.hasTiles && !assetStore.findTexture(m_tilemap->assetId)) {
+    return false;
+  }
+
+  const float originX = static_cast<float>(chunk.x * STATIC_CHUNK_SIZE);
+  const float originY = static_cast<float>(chunk.y * STATIC_CHUNK_SIZE);
+  m_bakeQueue.clear();
+  if (chunk.hasTiles) {
+    // depth 0: behind every sprite of the chunk
+    m_tileItems.clear();
+    m_tilemapRenderer.pushTiles(*m_tilemap, assetStore, originX, originY,
+                                originX + STATIC_CHUNK_SIZE,
+                                originY + STATIC_CHUNK_SIZE,
+                                glm::vec2(-originX, -originY), 1.0f,
+                                m_tileItems);
+    for (const auto& item : m_tileItems) {
+      m_bakeQueue.push(item);
+    }
+  }
+  for (const Entity& entity : chunk.entities) {
+    // sprites of layers with dynamic ones are drawn by the `RenderSystem`
+    if (m_dynamicLayers.test(chunk.layer)) {
+      break;
+    }
+    const auto& transform = entity.getComponent<TransformComponent>();
+    const auto& sprite = entity.getComponent<SpriteComponent>();
+    const TextureRegion* region = assetStore.findTexture(sprite.assetId);
+    if (!region) {
+      return false;
+    }
+
+    SDL_Rect srcRect = sprite.srcRect;
+    srcRect.x += region->rect.x;
+    srcRect.y += region->rect.y;
+    SDL_FRect dstRect = {transform.position.x - originX,
+                         transform.position.y - originY,
+                         sprite.width * transform.scale.x,
+                         sprite.height * transform.scale.y};
+    const float depth =
+        std::clamp(dstRect.y + dstRect.h + STATIC_CHUNK_SIZE, 0.0f,
+                   float(SORT_KEY_MAX_DEPTH));
+    m_bakeQueue.push({makeSortKey(0, static_cast<uint32_t>(depth),
+                                  region->page),
+                      region->texture, srcRect, dstRect, transform.rotation});
+  }
+  m_bakeQueue.sort();
+
+  const uint32_t firstItem = static_cast<uint32_t>(snapshot.bakeItems.size());
+  m_bakeQueue.forEachSorted([&snapshot](const RenderItem& item) {
+    snapshot.bakeItems.push_back(item);
+  });
+  snapshot.chunkBakes.push_back(
+      {key, firstItem,
+       static_cast<uint32_t>(snapshot.bakeItems.size()) - firstItem});
+  return true;
+}
+
+void StaticLayerCache::extract(const CameraResource& camera,
+                               AssetStore& assetStore,
+                               RenderSnapshot& snapshot) {
+  m_numBaked = 0;
+  for (auto& chunk : m_chunks) {
+    if (chunk.second.isDirty &&
+        extractBake(chunk.first, chunk.second, assetStore, snapshot)) {
+      chunk.second.isDirty = false;
+      m_numBaked++;
+    }
+  }
+
+  if (m_chunks.empty() || camera.zoom <= 0) {
+    return;
+  }
+
+  // world area covered by the viewport
+  const glm::vec2 viewMin = camera.position;
+  const glm::vec2 viewMax =
+      camera.position +
+      glm::vec2(camera.viewport.w, camera.viewport.h) / camera.zoom;
+  const int firstX = static_cast<int>(std::floor(viewMin.x / STATIC_CHUNK_SIZE));
+  const int firstY = static_cast<int>(std::floor(viewMin.y / STATIC_CHUNK_SIZE));
+  const int lastX = static_cast<int>(std::floor(viewMax.x / STATIC_CHUNK_SIZE));
+  const int lastY = static_cast<int>(std::floor(viewMax.y / STATIC_CHUNK_SIZE));
+  const float chunkScreenSize = STATIC_CHUNK_SIZE * camera.zoom;
+
+  for (int layer = 0; layer < 256; layer++) {
+    if (!m_layers.test(layer)) {
+      continue;
+    }
+    for (int y = firstY; y <= lastY; y++) {
+      for (int x = firstX; x <= lastX; x++) {
+        const uint64_t key = getChunkKey(layer, x, y);
+        auto chunk = m_chunks.find(key);
+        if (chunk == m_chunks.end() || isEmpty(chunk->second)) {
+          continue;
+        }
+        const glm::vec2 screenPosition = camera.worldToScreen(
+            glm::vec2(x * STATIC_CHUNK_SIZE, y * STATIC_CHUNK_SIZE));
+        // depth 0: drawn before the sprites drawn apart in the same layer
+        snapshot.chunkDraws.push_back({key,
+                                       makeSortKey(layer, 0, 0),
+                                       {screenPosition.x, screenPosition.y,
+                                        chunkScreenSize, chunkScreenSize}});
+      }
+    }
+  }
+}
@@ -0,0 +1,140 @@
+#ifndef STATICLAYERCACHE_HPP
+#define STATICLAYERCACHE_HPP
+#include "../AssetStore.hpp"
+#include "../Component.hpp"
+#include "../ECS.hpp"
+#include "../Resource.hpp"
+#include "RenderQueue.hpp"
+#include "RenderSnapshot.hpp"
+#include "TilemapRenderer.hpp"
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Side, in world units, of the square chunks static sprites are baked into.
+const int STATIC_CHUNK_SIZE = 512;
+
+/**
+ * Groups static sprites (`SpriteComponent::isStatic`) and the tiles of the
+ * tilemap into chunks, one set of chunks per render layer. Each chunk is baked
+ * once into a render-target texture by the `SnapshotRenderer` and then drawn as
+ * a single quad while it is visible. A chunk is re-baked only when a sprite in
+ * it is added, removed or changed, which the cache learns through
+ * `StaticSpriteTracker` registry indexes, or when the tilemap changes.
+ */
+class StaticLayerCache {
+  private:
+    struct Chunk {
+        uint8_t layer;
+        int x;
+        int y;
+        std::vector<Entity> entities;
+        // The tilemap overlaps the chunk.
+        bool hasTiles = false;
+        bool isDirty = true;
+    };
+
+    std::unordered_map<uint64_t, Chunk> m_chunks;
+
+    // Keys of the chunks overlapped by each entity. Index is the entity ID.
+    std::vector<std::vector<uint64_t>> m_entityChunks;
+
+    // Layers holding at least one chunk.
+    std::bitset<256> m_layers;
+    /*
+     * Layers also holding dynamic sprites: their chunks bake the tiles only,
+     * and `RenderSystem` draws their static sprites with a depth like the
+     * others.
+     */
+    std::bitset<256> m_dynamicLayers;
+
+    // Tilemap baked with the sprites, as of `m_tilemapVersion`.
+    const Tilemap* m_tilemap = nullptr;
+    uint8_t m_tilemapLayer = 0;
+    uint32_t m_tilemapVersion = 0;
+    TilemapRenderer m_tilemapRenderer;
+    std::vector<RenderItem> m_tileItems;
+
+    // Reused to sort a chunk's sprites back-to-front.
+    RenderQueue m_bakeQueue;
+
+    size_t m_numBaked = 0;
+
+    // Whether the chunk bakes nothing, with its layer's sprites drawn apart.
+    bool isEmpty(const Chunk& chunk) const {
+      return !chunk.hasTiles &&
+             (chunk.entities.empty() || m_dynamicLayers.test(chunk.layer));
+    }
+
+    // Queues the bake of a chunk, false if its textures are not ready yet.
+    bool extractBake(uint64_t key, const Chunk& chunk, AssetStore& assetStore,
+                     RenderSnapshot& snapshot);
+
+  public:
+    static uint64_t getChunkKey(uint8_t layer, int x, int y);
+
+    /**
+     * Adds a static sprite to every chunk its bounds overlap. Inserting it
+     * again moves it to its current bounds instead of adding it twice.
+     */
+    void insert(Entity entity);
+    // Removes a sprite from its chunks.
+    void erase(Entity entity);
+
+    // Marks every chunk for re-baking, e.g. after the render targets were lost.
+    void invalidateAll();
+
+    /**
+     * Layers holding dynamic sprites this frame. Their static sprites are left
+     * out of the chunks, so they sort by depth with the dynamic ones instead
+     * of always drawing behind them. Re-bakes the chunks of changed layers.
+     */
+    void setDynamicLayers(const std::bitset<256>& layers);
+    bool isDynamicLayer(uint8_t layer) const {
+      return m_dynamicLayers.test(layer);
+    }
+
+    /**
+     * Bakes the tiles of `tilemap` (null for none) behind the static sprites
+     * of `layer`. Called every frame: the chunks of the map are re-baked only
+     * when it changes, as told by `Tilemap::getVersion`.
+     */
+    void syncTilemap(const Tilemap* tilemap, uint8_t layer = 0);
+
+    /**
+     * Writes the bake commands of the dirty chunks and one quad per non-empty
+     * chunk visible from the camera into the snapshot.
+     */
+    void extract(const CameraResource& camera, AssetStore& assetStore,
+                 RenderSnapshot& snapshot);
+
+    // Number of chunks sent for baking by the last `extract`.
+    size_t getNumBaked() const { return m_numBaked; }
+};
+
+/**
+ * Registry index forwarding the changes of a component of static sprites
+ * (TransformComponent or SpriteComponent) to a `StaticLayerCache`.
+ */
+template <typename TComponent> class StaticSpriteTracker : public IComponentIndex {
+  private:
+    StaticLayerCache* m_cache;
+
+  public:
+    typedef TComponent ComponentType;
+
+    StaticSpriteTracker(StaticLayerCache* cache) : m_cache(cache) {}
+
+    void insert(Entity entity) override {
+      if (entity.hasComponent<TransformComponent>() &&
+          entity.hasComponent<SpriteComponent>() &&
+          entity.getComponent<SpriteComponent>().isStatic) {
+        m_cache->insert(entity);
+      }
+    }
+
+    void erase(Entity entity) override { m_cache->erase(entity); }
+};
+
+#endif
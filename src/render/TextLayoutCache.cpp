@@ -0,0 +1,71 @@
+#include "TextLayoutCache.hpp"
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+void TextLayoutCache::layOut(const Font& font, const std::string& text,
+                             TextLayout& layout) {
+  layout.quads.clear();
+  layout.width = 0;
+  int penX = 0;
+  int penY = 0;
+  char previous = '\0';
+  for (char c : text) {
+    if (c == '\n') {
+      penX = 0;
+      penY += font.lineSkip;
+      previous = '\0';
+      continue;
+    }
+
+    penX += font.getKerning(previous, c);
+    previous = c;
+    const FontGlyph& glyph = font.getGlyph(c);
+    if (glyph.region.texture != NULL_TEXTURE) {
+      const SDL_Rect& rect = glyph.region.rect;
+      layout.quads.push_back(
+          {glyph.region.texture,
+           glyph.region.page,
+           rect,
+           {static_cast<float>(penX + glyph.offsetX),
+            static_cast<float>(penY), static_cast<float>(rect.w),
+            static_cast<float>(rect.h)}});
+    }
+    penX += glyph.advance;
+    layout.width = std::max(layout.width, static_cast<float>(penX));
+  }
+  layout.height = static_cast<float>(penY + font.height);
+}
+
+const TextLayout& TextLayoutCache::getLayout(const Font& font,
+                                             const std::string& text) {
+  if (!font.isReady) {
+    layOut(font, text, m_unreadyLayout);
+    return m_unreadyLayout;
+  }
+  const size_t hash = std::hash<std::string_view>()(text) ^
+                      (std::hash<const Font*>()(&font) * 0x9e3779b97f4a7c15ull);
+  Entry& entry = m_entries[hash];
+  if (entry.font != &font || entry.text != text) {
+    entry.font = &font;
+    entry.text = text;
+    layOut(font, text, entry.layout);
+    m_numLayouts++;
+  }
+  entry.lastUsedFrame = m_frame;
+  return entry.layout;
+}
+
+void TextLayoutCache::endFrame() {
+  m_frame++;
+  if (m_frame % MAX_UNUSED_FRAMES != 0) {
+    return;
+  }
+  for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+    if (m_frame - entry->second.lastUsedFrame > MAX_UNUSED_FRAMES) {
+      entry = m_entries.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+}
@@ -0,0 +1,75 @@
+#ifndef TEXTLAYOUTCACHE_HPP
+#define TEXTLAYOUTCACHE_HPP
+#include "../AssetStore.hpp"
+#include "RenderDevice.hpp"
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Glyph quad of a laid out text.
+struct TextGlyphQuad {
+    TextureHandle texture;
+    uint16_t page;
+    SDL_Rect srcRect;
+    // Relative to the top-left corner of the text, in font pixels.
+    SDL_FRect dstRect;
+};
+
+struct TextLayout {
+    std::vector<TextGlyphQuad> quads;
+    // Size of the text block, in font pixels.
+    float width;
+    float height;
+};
+
+/**
+ * Lays out strings into glyph quads (kerning and '\n' line breaks included)
+ * and keeps the layouts, so a label whose text did not change costs a hash
+ * lookup per frame instead of a layout. Layouts unused for
+ * `MAX_UNUSED_FRAMES` frames are dropped.
+ */
+class TextLayoutCache {
+  private:
+    struct Entry {
+        const Font* font;
+        std::string text;
+        TextLayout layout;
+        uint64_t lastUsedFrame;
+    };
+
+    // By hash of the font and the text; a colliding text replaces the entry.
+    std::unordered_map<size_t, Entry> m_entries;
+    // Layout of a font whose glyphs are not resolved yet, never cached.
+    TextLayout m_unreadyLayout;
+    uint64_t m_frame = 0;
+    size_t m_numLayouts = 0;
+
+    static void layOut(const Font& font, const std::string& text,
+                       TextLayout& layout);
+
+  public:
+    static const uint64_t MAX_UNUSED_FRAMES = 120;
+
+    /**
+     * Layout of `text` in `font`, built on the first request. The reference
+     * is valid until the next `getLayout`. Until the font is ready the layout
+     * has no quads and is rebuilt on every request.
+     */
+    const TextLayout& getLayout(const Font& font, const std::string& text);
+
+    // Ends the frame, dropping the stale layouts every `MAX_UNUSED_FRAMES`.
+    void endFrame();
+
+    // Drops every layout, e.g. when the fonts are reloaded.
+    void clear() { m_entries.clear(); }
+
+    size_t getSize() const { return m_entries.size(); }
+
+    // Number of layouts built so far, cache misses included.
+    size_t getNumLayouts() const { return m_numLayouts; }
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "TilemapRenderer.hpp"
+#include <algorithm>
+#include <cmath>
+
+void TilemapRenderer::pushTiles(const Tilemap& tilemap, AssetStore& assetStore,
+                                float left, float top, float right,
+                                float bottom, glm::vec2 origin, float zoom,
+                                std::vector<RenderItem>& items,
+                                uint8_t layer) {
+  if (tilemap.getWidth() == 0) {
+    return;
+  }
+
+  // tile range covered by the area
+  const float tileWorldSize = tilemap.getTileWorldSize();
+  const int firstX =
+      std::max(0, static_cast<int>(std::floor(left / tileWorldSize)));
+  const int firstY =
+      std::max(0, static_cast<int>(std::floor(top / tileWorldSize)));
+  const int lastX =
+      std::min(tilemap.getWidth() - 1,
+               static_cast<int>(std::ceil(right / tileWorldSize)) - 1);
+  const int lastY =
+      std::min(tilemap.getHeight() - 1,
+               static_cast<int>(std::ceil(bottom / tileWorldSize)) - 1);
+  if (firstX > lastX || firstY > lastY) {
+    return;
+  }
+
+  const TextureRegion* region = assetStore.findTexture(tilemap.assetId);
+  if (!region) {
+    return;
+  }
+  const uint64_t sortKey = makeSortKey(layer, 0, region->page);
+  const float tileSize = tileWorldSize * zoom;
+
+  for (int chunkY = firstY / TILEMAP_CHUNK_SIZE;
+       chunkY <= lastY / TILEMAP_CHUNK_SIZE; chunkY++) {
+    for (int chunkX = firstX / TILEMAP_CHUNK_SIZE;
+         chunkX <= lastX / TILEMAP_CHUNK_SIZE; chunkX++) {
+      if (tilemap.isChunkEmpty(chunkX, chunkY)) {
+        continue;
+      }
+      const int startY = std::max(firstY, chunkY * TILEMAP_CHUNK_SIZE);
+      const int endY = std::min(lastY, (chunkY + 1) * TILEMAP_CHUNK_SIZE - 1);
+      const int startX = std::max(firstX, chunkX * TILEMAP_CHUNK_SIZE);
+      const int endX = std::min(lastX, (chunkX + 1) * TILEMAP_CHUNK_SIZE - 1);
+
+      for (int y = startY; y <= endY; y++) {
+        for (int x = startX; x <= endX; x++) {
+          const uint16_t tile = tilemap.getTile(x, y);
+          if (tile == TILE_EMPTY) {
+            continue;
+          }
+          SDL_Rect srcRect = tilemap.getTileSrcRect(tile);
+          srcRect.x += region->rect.x;
+          srcRect.y += region->rect.y;
+          items.push_back({sortKey,
+                           region->texture,
+                           srcRect,
+                           {origin.x + x * tileSize, origin.y + y * tileSize,
+                            tileSize, tileSize},
+                           0});
+          m_numTiles++;
+        }
+      }
+    }
+  }
+}
+
+void TilemapRenderer::pushVisibleTiles(const Tilemap& tilemap,
+                                       const CameraResource& camera,
+                                       AssetStore& assetStore,
+                                       std::vector<RenderItem>& items,
+                                       uint8_t layer) {
+  m_numTiles = 0;
+  if (camera.zoom <= 0) {
+    return;
+  }
+
+  const glm::vec2 viewMax =
+      camera.position +
+      glm::vec2(camera.viewport.w, camera.viewport.h) / camera.zoom;
+  pushTiles(tilemap, assetStore, camera.position.x, camera.position.y,
+            viewMax.x, viewMax.y, camera.worldToScreen(glm::vec2(0, 0)),
+            camera.zoom, items, layer);
+}
@@ -0,0 +1,39 @@
+#ifndef TILEMAPRENDERER_HPP
+#define TILEMAPRENDERER_HPP
+#include "../AssetStore.hpp"
+#include "../Resource.hpp"
+#include "../Tilemap.hpp"
+#include "RenderQueue.hpp"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * Collects the quads of the `Tilemap` tiles inside an area: the viewport of
+ * the camera, or a static chunk being baked. Only the tilemap chunks
+ * overlapping the area are visited, empty chunks are skipped and tile source
+ * rectangles are computed from the tile index.
+ */
+class TilemapRenderer {
+  private:
+    size_t m_numTiles = 0;
+
+  public:
+    /**
+     * Pushes the tiles overlapping the world rectangle `[left, right) x
+     * [top, bottom)`, placed at `origin + worldPosition * zoom`.
+     */
+    void pushTiles(const Tilemap& tilemap, AssetStore& assetStore, float left,
+                   float top, float right, float bottom, glm::vec2 origin,
+                   float zoom, std::vector<RenderItem>& items,
+                   uint8_t layer = 0);
+
+    void pushVisibleTiles(const Tilemap& tilemap, const CameraResource& camera,
+                          AssetStore& assetStore,
+                          std::vector<RenderItem>& items, uint8_t layer = 0);
+
+    // Number of tiles collected by the last `pushVisibleTiles`.
+    size_t getNumTiles() const { return m_numTiles; }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef ANIMATIONSYSTEM_H
+#define ANIMATIONSYSTEM_H
+
+#include "../AnimationClips.hpp"
+#include "../Component.hpp"
+#include "../ECS.hpp"
+#include "../Resource.hpp"
+#include "../utils/Log.hpp"
+
+/**
+ * Advances every `AnimationComponent` by one tick and sets the sprite source
+ * rectangle to the current frame of its clip. Clip data comes from the
+ * `AnimationClips` resource; per entity there is only a clip id and a time.
+ * The loop reads the component pools directly and wraps and looks up frames
+ * without branching on the clip mode, so thousands of animated sprites cost a
+ * few microseconds per tick. Entities whose clip does not exist (e.g.
+ * `ANIMATION_CLIP_NONE`, or any clip before one is added) are left as is.
+ *
+ * Writing the pool directly bypasses the secondary indexes of
+ * `SpriteComponent`, so none should index `srcRect`. Static sprites are baked
+ * once and would never show a new frame: they are not animated.
+ */
+class AnimationSystem : public System {
+  public:
+    AnimationSystem() {
+      requireComponent<AnimationComponent>();
+      requireComponent<SpriteComponent>();
+      readResource<FrameTimeResource>();
+      readResource<AnimationClips>();
+    }
+
+    void update() {
+      const auto& entities = getEntities();
+      if (entities.empty()) {
+        return;
+      }
+      const float dt = static_cast<float>(
+          registry->getResource<FrameTimeResource>().deltaTime);
+      const auto& clips = registry->getResource<AnimationClips>();
+      const size_t numClips = clips.getNumClips();
+      AnimationComponent* animations =
+          registry->getPool<AnimationComponent>().getData();
+      SpriteComponent* sprites = registry->getPool<SpriteComponent>().getData();
+
+      for (const Entity& entity : entities) {
+        const uint16_t entityId = entity.getId();
+        AnimationComponent& animation = animations[entityId];
+        if (animation.clip >= numClips) {
+          continue;
+        }
+        if (sprites[entityId].isStatic) {
+          LOG_EVERY_N(WARN, 1000,
+                      "[AnimationSystem] Entity {} has a static sprite, it "
+                      "is not animated",
+                      entityId);
+          continue;
+        }
+        animation.time = clips.wrapTime(animation.clip, animation.time + dt);
+        sprites[entityId].srcRect =
+            clips.getFrameRect(animation.clip, animation.time);
+      }
+    }
+};
+
+#endif
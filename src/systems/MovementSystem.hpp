@@ -3,15 +3,19 @@
 
 #include "../Component.hpp"
 #include "../ECS.hpp"
+#include "../Resource.hpp"
+#include "../utils/Log.hpp"
 
 class MovementSystem : public System {
   public:
     MovementSystem() {
       requireComponent<TransformComponent>();
       requireComponent<RigidBodyComponent>();
+      readResource<FrameTimeResource>();
     }
 
-    void update(const double& dt) {
+    void update() {
+      const double dt = registry->getResource<FrameTimeResource>().deltaTime;
       for (auto entity : getEntities()) {
         auto& transform = entity.getComponent<TransformComponent>();
         const auto& rigidBodyComponent =
@@ -20,12 +24,20 @@ class MovementSystem : public System {
         transform.position.x += rigidBodyComponent.velocity.x * dt;
         transform.position.y += rigidBodyComponent.velocity.y * dt;
 
-        spdlog::info(
-            "[MovementSystem] entityId=" + std::to_string(entity.getId()) +
-            " position is now (" + std::to_string(transform.position.x) + ", " +
-            std::to_string(transform.position.y) + ")");
+        LOG_TRACE("[MovementSystem] entityId={} position is now ({}, {})",
+                  entity.getId(), transform.position.x, transform.position.y);
       }
     }
+
+    // Same update for the statically typed `World` used in shipping builds.
+    template <typename TWorld> void update(TWorld& world, const double& dt) {
+      world.template each<TransformComponent, RigidBodyComponent>(
+          [dt](uint16_t, TransformComponent& transform,
+               const RigidBodyComponent& rigidBody) {
+            transform.position.x += rigidBody.velocity.x * dt;
+            transform.position.y += rigidBody.velocity.y * dt;
+          });
+    }
 };
 
 #endif
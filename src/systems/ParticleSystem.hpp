@@ -0,0 +1,210 @@
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include "../AssetStore.hpp"
+#include "../Component.hpp"
+#include "../ECS.hpp"
+#include "../ParticlePool.hpp"
+#include "../Resource.hpp"
+#include "../render/RenderQueue.hpp"
+#include "../render/RenderSnapshot.hpp"
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Simulates and extracts particles without making them entities. Emitters are
+ * components; the particles they spawn live in `ParticlePool`s, one per
+ * texture region and layer, kept sorted by layer and asset so that `extract`
+ * emits one `ParticleBatch` (one draw call) per texture and layer.
+ */
+class ParticleSystem : public System {
+  private:
+    std::vector<ParticlePool> m_pools;
+    // xorshift32 state: cheap and deterministic across runs.
+    uint32_t m_random = 0x9e3779b9;
+
+    float random(float min, float max) {
+      m_random ^= m_random << 13;
+      m_random ^= m_random >> 17;
+      m_random ^= m_random << 5;
+      return min + (max - min) * (m_random >> 8) * (1.0f / (1u << 24));
+    }
+
+    ParticlePool& getPool(const ParticleEmitterComponent& emitter) {
+      auto pool = m_pools.begin();
+      for (; pool != m_pools.end(); ++pool) {
+        if (pool->zIndex == emitter.zIndex &&
+            pool->assetId == emitter.assetId &&
+            SDL_RectEquals(&pool->srcRect, &emitter.srcRect)) {
+          return *pool;
+        }
+        if (pool->zIndex > emitter.zIndex ||
+            (pool->zIndex == emitter.zIndex &&
+             pool->assetId > emitter.assetId)) {
+          break;
+        }
+      }
+      return *m_pools.insert(pool, ParticlePool(emitter.assetId,
+                                                emitter.srcRect,
+                                                emitter.zIndex));
+    }
+
+    void emit(ParticlePool& pool, const ParticleEmitterComponent& emitter,
+              glm::vec2 origin, uint32_t count) {
+      const float halfSpread = emitter.spread * 0.5f;
+      for (uint32_t i = 0; i < count; i++) {
+        const float angle =
+            random(emitter.direction - halfSpread,
+                   emitter.direction + halfSpread) *
+            static_cast<float>(M_PI / 180.0);
+        const float speed = random(emitter.minSpeed, emitter.maxSpeed);
+        pool.emit(origin.x, origin.y, std::cos(angle) * speed,
+                  std::sin(angle) * speed,
+                  random(emitter.minLifetime, emitter.maxLifetime),
+                  emitter.startColor, emitter.endColor);
+      }
+    }
+
+  public:
+    ParticleSystem() {
+      requireComponent<TransformComponent>();
+      requireComponent<ParticleEmitterComponent>();
+      readResource<FrameTimeResource>();
+      readResource<CameraResource>();
+    }
+
+    size_t getNumParticles() const {
+      size_t numParticles = 0;
+      for (const auto& pool : m_pools) {
+        numParticles += pool.getNumParticles();
+      }
+      return numParticles;
+    }
+
+    // Emits this tick's particles, then moves and ages every particle.
+    void update() {
+      const float dt = static_cast<float>(
+          registry->getResource<FrameTimeResource>().deltaTime);
+
+      for (auto entity : getEntities()) {
+        auto& emitter = entity.getComponent<ParticleEmitterComponent>();
+        if (emitter.maxLifetime <= 0) {
+          continue;
+        }
+        emitter.pendingEmission += emitter.rate * dt;
+        const uint32_t count =
+            static_cast<uint32_t>(emitter.pendingEmission) + emitter.burst;
+        emitter.pendingEmission -= std::floor(emitter.pendingEmission);
+        emitter.burst = 0;
+        if (count == 0) {
+          continue;
+        }
+
+        const auto& transform = entity.getComponent<TransformComponent>();
+        emit(getPool(emitter), emitter, transform.position + emitter.offset,
+             count);
+      }
+
+      for (auto& pool : m_pools) {
+        pool.update(dt);
+      }
+    }
+
+    /**
+     * Writes the visible particles into the snapshot, interpolated between
+     * the last two ticks like sprites, one batch per texture and layer. They
+     * are drawn over the sprites of their layer.
+     */
+    void extract(RenderSnapshot& snapshot, AssetStore& assetStore) {
+      const auto& camera = registry->getResource<CameraResource>();
+      const auto& frameTime = registry->getResource<FrameTimeResource>();
+      // positions are linear in time: step back by the part not yet reached
+      const float rewind =
+          static_cast<float>(frameTime.deltaTime) * (frameTime.alpha - 1.0f);
+      // locals, so the particle stores cannot alias them inside the loop
+      const float zoom = camera.zoom;
+      const float viewportLeft = camera.viewport.x;
+      const float viewportTop = camera.viewport.y;
+      const float viewportRight = viewportLeft + camera.viewport.w;
+      const float viewportBottom = viewportTop + camera.viewport.h;
+
+      for (const auto& pool : m_pools) {
+        const size_t numParticles = pool.getNumParticles();
+        if (numParticles == 0) {
+          continue;
+        }
+        const TextureRegion* region = assetStore.findTexture(pool.assetId);
+        if (!region) {
+          continue;
+        }
+        SDL_Rect srcRect = pool.srcRect;
+        srcRect.x += region->rect.x;
+        srcRect.y += region->rect.y;
+        const float width = pool.srcRect.w * zoom;
+        const float height = pool.srcRect.h * zoom;
+        // screen corner of a quad centered on the world origin
+        const glm::vec2 origin = camera.worldToScreen(glm::vec2(0, 0)) -
+                                 0.5f * glm::vec2(width, height);
+        const float originX = origin.x;
+        const float originY = origin.y;
+
+        const float* positionX = pool.getPositionX();
+        const float* positionY = pool.getPositionY();
+        const float* velocityX = pool.getVelocityX();
+        const float* velocityY = pool.getVelocityY();
+        const float* life = pool.getLife();
+        const float* inverseLifetime = pool.getInverseLifetime();
+        const uint64_t* startColor = pool.getStartColor();
+        const uint64_t* endColor = pool.getEndColor();
+
+        // room for every particle, trimmed to the visible ones afterwards
+        auto& particles = snapshot.particles;
+        const size_t firstParticle = particles.size();
+        particles.resize(firstParticle + numParticles);
+        ParticleInstance* particle = &particles[firstParticle];
+        for (size_t i = 0; i < numParticles; i++) {
+          const float x =
+              originX + (positionX[i] + velocityX[i] * rewind) * zoom;
+          const float y =
+              originY + (positionY[i] + velocityY[i] * rewind) * zoom;
+          if (x + width <= viewportLeft || x >= viewportRight ||
+              y + height <= viewportTop || y >= viewportBottom) {
+            continue;
+          }
+
+          // age in 1/256ths of the lifetime
+          const uint32_t age = static_cast<uint32_t>(
+              256.0f - life[i] * inverseLifetime[i] * 256.0f);
+          particle->x = x;
+          particle->y = y;
+          particle->color = blendColors(startColor[i], endColor[i], age);
+          particle++;
+        }
+        const uint32_t numVisible =
+            static_cast<uint32_t>(particle - &particles[firstParticle]);
+        particles.resize(firstParticle + numVisible);
+        if (numVisible == 0) {
+          continue;
+        }
+
+        const uint64_t sortKey =
+            makeSortKey(pool.zIndex, SORT_KEY_MAX_DEPTH, region->page);
+        auto& batches = snapshot.particleBatches;
+        // pools of the same texture and layer are neighbours: one draw call
+        if (batches.empty() || batches.back().sortKey != sortKey ||
+            batches.back().texture != region->texture) {
+          batches.push_back(
+              {sortKey, region->texture,
+               static_cast<uint32_t>(snapshot.particleRuns.size()), 0});
+        }
+        batches.back().numRuns++;
+        snapshot.particleRuns.push_back({srcRect, width, height,
+                                         static_cast<uint32_t>(firstParticle),
+                                         numVisible});
+      }
+    }
+};
+
+#endif
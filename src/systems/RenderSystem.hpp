@@ -4,32 +4,144 @@
 #include "../AssetStore.hpp"
 #include "../Component.hpp"
 #include "../ECS.hpp"
+#include "../Resource.hpp"
+#include "../render/RenderQueue.hpp"
+#include "../render/RenderSnapshot.hpp"
+#include "../render/StaticLayerCache.hpp"
+#include "../render/TilemapRenderer.hpp"
 #include <SDL2/SDL.h>
+#include <algorithm>
+#include <bitset>
+#include <cmath>
 
+/**
+ * Extract stage of the renderer: turns the visible sprites, tiles and static
+ * chunks into a `RenderSnapshot`. It never calls SDL, so the snapshot can be
+ * submitted by a `SnapshotRenderer` on the render thread while the next frame
+ * is simulated.
+ */
 class RenderSystem : public System {
+  private:
+    StaticLayerCache m_staticLayerCache;
+    TilemapRenderer m_tilemapRenderer;
+    // The tilemap is baked into the static chunks instead of drawn per tile.
+    bool m_isTrackingStatic = false;
+    // Entities skipped by the last update because they were off-screen.
+    size_t m_numCulled = 0;
+
   public:
     RenderSystem() {
       requireComponent<TransformComponent>();
       requireComponent<SpriteComponent>();
+      readResource<CameraResource>();
+      readResource<FrameTimeResource>();
+      readResource<Tilemap>();
     }
 
-    void update(SDL_Renderer* renderer, AssetStore& assetStore) {
+    size_t getNumCulled() const { return m_numCulled; }
+
+    /**
+     * Registers the indexes that keep the static layer cache in sync with the
+     * registry. Static sprites and the tilemap are then drawn from baked
+     * chunks.
+     */
+    void trackStaticSprites() {
+      m_isTrackingStatic = true;
+      registry->addIndex<StaticSpriteTracker<TransformComponent>>(
+          &m_staticLayerCache);
+      registry->addIndex<StaticSpriteTracker<SpriteComponent>>(
+          &m_staticLayerCache);
+    }
+
+    // Re-bakes every static chunk, e.g. after SDL lost the render targets.
+    void invalidateStaticLayers() { m_staticLayerCache.invalidateAll(); }
+
+    void update(RenderSnapshot& snapshot, AssetStore& assetStore) {
+      const auto& camera = registry->getResource<CameraResource>();
+      const float alpha = registry->hasResource<FrameTimeResource>()
+                              ? registry->getResource<FrameTimeResource>().alpha
+                              : 1.0f;
+      const float viewportRight = camera.viewport.x + camera.viewport.w;
+      const float viewportBottom = camera.viewport.y + camera.viewport.h;
+
+      m_numCulled = 0;
+      const Tilemap* tilemap = registry->hasResource<Tilemap>()
+                                   ? &registry->getResource<Tilemap>()
+                                   : nullptr;
+      if (m_isTrackingStatic) {
+        // a layer with dynamic sprites keeps its static ones in depth order
+        std::bitset<256> dynamicLayers;
+        for (auto entity : getEntities()) {
+          const auto& sprite = entity.getComponent<SpriteComponent>();
+          if (!sprite.isStatic) {
+            dynamicLayers.set(sprite.zIndex);
+          }
+        }
+        m_staticLayerCache.setDynamicLayers(dynamicLayers);
+        m_staticLayerCache.syncTilemap(tilemap);
+      } else if (tilemap) {
+        m_tilemapRenderer.pushVisibleTiles(*tilemap, camera, assetStore,
+                                           snapshot.items);
+      }
+      m_staticLayerCache.extract(camera, assetStore, snapshot);
       for (auto entity : getEntities()) {
-        const auto transform = entity.getComponent<TransformComponent>();
-        const auto sprite = entity.getComponent<SpriteComponent>();
+        const auto& sprite = entity.getComponent<SpriteComponent>();
+        // static sprites reach the cache only once they are tracked
+        if (m_isTrackingStatic && sprite.isStatic &&
+            !m_staticLayerCache.isDynamicLayer(sprite.zIndex)) {
+          continue;
+        }
+        const auto& transform = entity.getComponent<TransformComponent>();
+
+        // Set the destination rectangle with the position to be rendered,
+        // interpolated between the last two simulation ticks
+        const glm::vec2 position =
+            glm::mix(transform.previousPosition, transform.position, alpha);
+        // rotation turns the short way, e.g. 350 to 10 degrees through 0
+        const float turn = std::remainder(
+            transform.rotation - transform.previousRotation, 360.0f);
+        const float rotation = transform.previousRotation + turn * alpha;
+        const glm::vec2 screenPosition = camera.worldToScreen(position);
+        SDL_FRect dstRect = {screenPosition.x, screenPosition.y,
+                             sprite.width * transform.scale.x * camera.zoom,
+                             sprite.height * transform.scale.y * camera.zoom};
 
-        // Set the source rectangle of our original sprite texture
+        // Screen bounds; rotated sprites are bounded by their circumcircle
+        float boundsLeft = dstRect.x;
+        float boundsTop = dstRect.y;
+        float boundsRight = dstRect.x + dstRect.w;
+        float boundsBottom = dstRect.y + dstRect.h;
+        if (rotation != 0.0) {
+          const float radius = 0.5f * std::hypot(dstRect.w, dstRect.h);
+          const float centerX = dstRect.x + 0.5f * dstRect.w;
+          const float centerY = dstRect.y + 0.5f * dstRect.h;
+          boundsLeft = centerX - radius;
+          boundsTop = centerY - radius;
+          boundsRight = centerX + radius;
+          boundsBottom = centerY + radius;
+        }
+        if (boundsRight <= camera.viewport.x || boundsLeft >= viewportRight ||
+            boundsBottom <= camera.viewport.y || boundsTop >= viewportBottom) {
+          m_numCulled++;
+          continue;
+        }
+
+        // Source rectangle is relative to the asset, which may live in an atlas
+        const TextureRegion* region = assetStore.findTexture(sprite.assetId);
+        if (!region) {
+          continue;
+        }
         SDL_Rect srcRect = sprite.srcRect;
-        SDL_Rect dstRect = {
-            static_cast<int>(transform.position.x),
-            static_cast<int>(transform.position.y),
-            static_cast<int>(sprite.width * transform.scale.x),
-            static_cast<int>(sprite.height * transform.scale.y)};
-        SDL_RendererFlip flip = SDL_FLIP_NONE;
-
-        // Set the destination rectangle with the position to be rendered
-        SDL_RenderCopyEx(renderer, assetStore.getTexture(sprite.assetId),
-                         &srcRect, &dstRect, transform.rotation, NULL, flip);
+        srcRect.x += region->rect.x;
+        srcRect.y += region->rect.y;
+
+        // back-to-front inside a layer: sprites lower on screen are in front
+        const float depth = std::clamp(boundsBottom + SORT_KEY_MAX_DEPTH / 2.0f,
+                                       0.0f, float(SORT_KEY_MAX_DEPTH));
+        snapshot.items.push_back({makeSortKey(sprite.zIndex,
+                                              static_cast<uint32_t>(depth),
+                                              region->page),
+                                  region->texture, srcRect, dstRect, rotation});
       }
     }
 };
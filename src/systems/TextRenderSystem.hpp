@@ -0,0 +1,89 @@
+#ifndef TEXTRENDERSYSTEM_H
+#define TEXTRENDERSYSTEM_H
+
+#include "../AssetStore.hpp"
+#include "../Component.hpp"
+#include "../ECS.hpp"
+#include "../Resource.hpp"
+#include "../render/RenderQueue.hpp"
+#include "../render/RenderSnapshot.hpp"
+#include "../render/TextLayoutCache.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+
+/**
+ * Extract stage of the text labels: each glyph becomes a tinted quad of the
+ * font's atlas page, sorted and batched with the sprites. Glyphs were
+ * rasterized once by the `AssetStore` and layouts are cached, so drawing an
+ * unchanged label allocates nothing.
+ */
+class TextRenderSystem : public System {
+  private:
+    TextLayoutCache m_layoutCache;
+
+  public:
+    TextRenderSystem() {
+      requireComponent<TransformComponent>();
+      requireComponent<TextLabelComponent>();
+      readResource<CameraResource>();
+      readResource<FrameTimeResource>();
+    }
+
+    const TextLayoutCache& getLayoutCache() const { return m_layoutCache; }
+
+    void update(RenderSnapshot& snapshot, const AssetStore& assetStore) {
+      const auto& camera = registry->getResource<CameraResource>();
+      const float alpha = registry->hasResource<FrameTimeResource>()
+                              ? registry->getResource<FrameTimeResource>().alpha
+                              : 1.0f;
+      const float viewportRight = camera.viewport.x + camera.viewport.w;
+      const float viewportBottom = camera.viewport.y + camera.viewport.h;
+
+      for (auto entity : getEntities()) {
+        const auto& label = entity.getComponent<TextLabelComponent>();
+        if (label.text.empty()) {
+          continue;
+        }
+        const Font* font = assetStore.findFont(label.fontId);
+        if (!font) {
+          continue;
+        }
+        const auto& transform = entity.getComponent<TransformComponent>();
+        const TextLayout& layout = m_layoutCache.getLayout(*font, label.text);
+
+        glm::vec2 origin = transform.position;
+        glm::vec2 scale = transform.scale;
+        if (!label.isFixed) {
+          origin = camera.worldToScreen(
+              glm::mix(transform.previousPosition, transform.position, alpha));
+          scale *= camera.zoom;
+        }
+        const float right = origin.x + layout.width * scale.x;
+        const float bottom = origin.y + layout.height * scale.y;
+        if (right <= camera.viewport.x || origin.x >= viewportRight ||
+            bottom <= camera.viewport.y || origin.y >= viewportBottom) {
+          continue;
+        }
+
+        // fixed labels go over their layer, world labels sort like sprites
+        const uint32_t depth =
+            label.isFixed
+                ? SORT_KEY_MAX_DEPTH
+                : static_cast<uint32_t>(
+                      std::clamp(bottom + SORT_KEY_MAX_DEPTH / 2.0f, 0.0f,
+                                 float(SORT_KEY_MAX_DEPTH)));
+        for (const auto& quad : layout.quads) {
+          const SDL_FRect dstRect = {origin.x + quad.dstRect.x * scale.x,
+                                     origin.y + quad.dstRect.y * scale.y,
+                                     quad.dstRect.w * scale.x,
+                                     quad.dstRect.h * scale.y};
+          snapshot.items.push_back(
+              {makeSortKey(label.zIndex, depth, quad.page), quad.texture,
+               quad.srcRect, dstRect, 0, label.color});
+        }
+      }
+      m_layoutCache.endFrame();
+    }
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef TRANSFORMHISTORYSYSTEM_H
+#define TRANSFORMHISTORYSYSTEM_H
+
+#include "../Component.hpp"
+#include "../ECS.hpp"
+
+/**
+ * Runs first in every simulation tick and stores the current transforms as the
+ * previous ones, so rendering can interpolate whatever the other systems (or
+ * the game code) change during the tick.
+ */
+class TransformHistorySystem : public System {
+  public:
+    TransformHistorySystem() { requireComponent<TransformComponent>(); }
+
+    void update() {
+      for (auto entity : getEntities()) {
+        auto& transform = entity.getComponent<TransformComponent>();
+        transform.previousPosition = transform.position;
+        transform.previousRotation = transform.rotation;
+      }
+    }
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * Engine logging macros on top of spdlog with compile-time severity filtering.
+ * Calls below `FLATLAND_LOG_LEVEL` expand to nothing, so their arguments are
+ * never evaluated and they cost nothing in release builds. Messages use fmt
+ * syntax and are only formatted when the level is enabled:
+ *
+ *   LOG_TRACE("[MovementSystem] entityId={} x={}", entity.getId(), x);
+ *
+ * Build with `-DFLATLAND_LOG_LEVEL=0` to keep every level (see the Makefile
+ * `debug` target).
+ */
+
+#ifndef LOG_HPP
+#define LOG_HPP
+#include "spdlog/spdlog.h"
+#include <atomic>
+#include <cstdint>
+
+#define FLATLAND_LOG_LEVEL_TRACE 0
+#define FLATLAND_LOG_LEVEL_DEBUG 1
+#define FLATLAND_LOG_LEVEL_INFO 2
+#define FLATLAND_LOG_LEVEL_WARN 3
+#define FLATLAND_LOG_LEVEL_ERROR 4
+#define FLATLAND_LOG_LEVEL_OFF 6
+
+#ifndef FLATLAND_LOG_LEVEL
+#define FLATLAND_LOG_LEVEL FLATLAND_LOG_LEVEL_INFO
+#endif
+
+#if FLATLAND_LOG_LEVEL <= FLATLAND_LOG_LEVEL_TRACE
+#define LOG_TRACE(...) spdlog::trace(__VA_ARGS__)
+#else
+#define LOG_TRACE(...) (void)0
+#endif
+
+#if FLATLAND_LOG_LEVEL <= FLATLAND_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) spdlog::debug(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) (void)0
+#endif
+
+#if FLATLAND_LOG_LEVEL <= FLATLAND_LOG_LEVEL_INFO
+#define LOG_INFO(...) spdlog::info(__VA_ARGS__)
+#else
+#define LOG_INFO(...) (void)0
+#endif
+
+#if FLATLAND_LOG_LEVEL <= FLATLAND_LOG_LEVEL_WARN
+#define LOG_WARN(...) spdlog::warn(__VA_ARGS__)
+#else
+#define LOG_WARN(...) (void)0
+#endif
+
+#if FLATLAND_LOG_LEVEL <= FLATLAND_LOG_LEVEL_ERROR
+#define LOG_ERROR(...) spdlog::error(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) (void)0
+#endif
+
+/*
+ * Rate-limited variant for hot loops: logs the 1st, (n+1)th, (2n+1)th... call
+ * of this call site. `level` is one of TRACE, DEBUG, INFO, WARN or ERROR. The
+ * counter is per call site; when the level is compiled out, the body is a
+ * discarded `if constexpr` branch, so the call does no counting at all.
+ *
+ *   LOG_EVERY_N(DEBUG, 1000, "[RenderSystem] {} sprites", count);
+ */
+#define LOG_EVERY_N(level, n, ...)                                             \
+  do {                                                                         \
+    if constexpr (FLATLAND_LOG_LEVEL <= FLATLAND_LOG_LEVEL_##level) {          \
+      static std::atomic<uint32_t> logEveryNCounter{0};                        \
+      if (logEveryNCounter.fetch_add(1, std::memory_order_relaxed) % (n) ==    \
+          0) {                                                                 \
+        LOG_##level(__VA_ARGS__);                                              \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+/*
+ * Runtime level matching the compile-time one, so the compiled-in trace and
+ * debug calls are not filtered again by spdlog's default (info) level.
+ */
+inline void initializeLogLevel() {
+  spdlog::set_level(static_cast<spdlog::level::level_enum>(FLATLAND_LOG_LEVEL));
+}
+
+#endif
@@ -1,15 +1,25 @@
 /*
- * toy logger implementation using std::cout. Not fast enough ot be used in the
- * engine. Use spdlog instead.
+ * Asynchronous logger. Producers copy the message into a fixed-size entry of a
+ * bounded lock-free ring buffer and return; a background thread formats the
+ * timestamps and writes the entries to stdout. Memory is fixed at
+ * configuration time: when the buffer is full, new messages are either dropped
+ * or overwrite the oldest ones (see `LogOverflowPolicy`). The engine itself
+ * logs through spdlog (see `Log.hpp`).
  */
 
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
-#include <iostream>
+#include <memory>
 #include <string>
-#include <vector>
+#include <string_view>
+#include <thread>
 
 // ANSI escape codes for colors
 const std::string RED("\033[31m");
@@ -18,76 +28,272 @@ const std::string GREEN("\033[32m");
 const std::string RESET("\033[0m");
 enum LogType { INFO, WARNING, ERROR };
 
+// What happens to a new message when the ring buffer is full.
+enum LogOverflowPolicy { DROP_NEWEST, OVERWRITE_OLDEST };
+
+// Longest message stored in an entry, longer messages are truncated.
+const size_t LOG_MESSAGE_SIZE = 232;
+const size_t LOG_DEFAULT_CAPACITY = 4096;
+
 struct LogEntry {
     LogType type;
-    std::string message;
+    // Wall-clock time of the call, in nanoseconds since the epoch.
+    int64_t timestamp;
+    uint16_t length;
+    char message[LOG_MESSAGE_SIZE];
 };
 
 /**
- * Generates a timestamp string in ISO 8601 format.
- *
- * This function retrieves the current system time and formats it as a string
- * in the ISO 8601 format (YYYY-MM-DDTHH:MM:SS).
- *
- * Returns a string representing the current timestamp in ISO 8601 format.
+ * Bounded multi-producer multi-consumer queue of log entries (Dmitry Vyukov's
+ * algorithm). Each cell carries a sequence number telling producers and
+ * consumers whether it is free or filled for their lap, so pushing and popping
+ * only take a CAS on the shared position. Capacity is rounded up to a power of
+ * two.
  */
-inline std::string getTimestamp() {
-  std::time_t now =
-      std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-  std::string output(30, '\0');
-  std::strftime(&output[0], output.size(), "%Y-%m-%dT%H:%M:%S",
-                std::localtime(&now));
+class LogRingBuffer {
+  private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogEntry entry;
+    };
 
-  return output;
-}
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueuePosition;
+    alignas(64) std::atomic<size_t> m_dequeuePosition;
 
-class Logger {
   public:
+    explicit LogRingBuffer(size_t capacity) {
+      size_t size = 2;
+      while (size < capacity) {
+        size *= 2;
+      }
+      m_cells = std::make_unique<Cell[]>(size);
+      m_mask = size - 1;
+      for (size_t i = 0; i < size; i++) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
+      m_enqueuePosition.store(0, std::memory_order_relaxed);
+      m_dequeuePosition.store(0, std::memory_order_relaxed);
+    }
+
+    size_t getCapacity() const { return m_mask + 1; }
+
     /**
-     * Holds a collection of log entries.
-     *
-     * This vector stores instances of LogEntry, which represent individual log
-     * messages. It is used to keep track of all log messages generated by the
-     * Logger.
+     * Claims a free cell and calls `fill(LogEntry&)` on it. Returns false
+     * without waiting if the buffer is full.
      */
-    static std::vector<LogEntry> m_messages;
+    template <typename TFill> bool tryPush(TFill&& fill) {
+      size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+      Cell* cell;
+      for (;;) {
+        cell = &m_cells[position & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t difference =
+            static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+          if (m_enqueuePosition.compare_exchange_weak(
+                  position, position + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (difference < 0) {
+          return false;
+        } else {
+          position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+      }
+
+      fill(cell->entry);
+      cell->sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Moves the oldest entry into `entry`. Returns false if the buffer is empty.
+    bool tryPop(LogEntry& entry) {
+      size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+      Cell* cell;
+      for (;;) {
+        cell = &m_cells[position & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) -
+                              static_cast<intptr_t>(position + 1);
+        if (difference == 0) {
+          if (m_dequeuePosition.compare_exchange_weak(
+                  position, position + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (difference < 0) {
+          return false;
+        } else {
+          position = m_dequeuePosition.load(std::memory_order_relaxed);
+        }
+      }
+
+      std::memcpy(&entry, &cell->entry, sizeof(LogEntry));
+      cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+      return true;
+    }
+};
+
+class Logger {
+  private:
+    LogRingBuffer m_buffer;
+    LogOverflowPolicy m_policy;
+    std::atomic<bool> m_isRunning;
+    std::atomic<uint64_t> m_numLost;
+    std::thread m_worker;
+
+    // Start of the second whose ISO 8601 string is cached in `m_timestamp`.
+    int64_t m_timestampSecond = -1;
+    char m_timestamp[32];
+
+    static size_t& configuredCapacity() {
+      static size_t capacity = LOG_DEFAULT_CAPACITY;
+      return capacity;
+    }
+
+    static LogOverflowPolicy& configuredPolicy() {
+      static LogOverflowPolicy policy = DROP_NEWEST;
+      return policy;
+    }
+
+    // Created, with its background thread, on the first log call.
+    static Logger& getInstance() {
+      static Logger logger(configuredCapacity(), configuredPolicy());
+      return logger;
+    }
+
+    Logger(size_t capacity, LogOverflowPolicy policy) : m_buffer(capacity) {
+      m_policy = policy;
+      m_isRunning.store(true);
+      m_numLost.store(0);
+      m_worker = std::thread(&Logger::drainLoop, this);
+    }
+
+    ~Logger() {
+      m_isRunning.store(false);
+      m_worker.join();
+    }
+
+    void push(LogType type, std::string_view message) {
+      const int64_t timestamp =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::system_clock::now().time_since_epoch())
+              .count();
+      auto fill = [&](LogEntry& entry) {
+        entry.type = type;
+        entry.timestamp = timestamp;
+        entry.length = static_cast<uint16_t>(
+            std::min(message.size(), LOG_MESSAGE_SIZE));
+        std::memcpy(entry.message, message.data(), entry.length);
+      };
+
+      while (!m_buffer.tryPush(fill)) {
+        if (m_policy == DROP_NEWEST) {
+          m_numLost.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        // make room by discarding the oldest entry, then try again
+        LogEntry discarded;
+        if (m_buffer.tryPop(discarded)) {
+          m_numLost.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
 
     /**
-     * Logs an informational message. The message is prefixed with a timestamp
-     * and the "INFO" label. The log entry is then added to the internal message
-     * list and printed to the console in green color.
+     * Formats the timestamp in ISO 8601 (YYYY-MM-DDTHH:MM:SS). `strftime` only
+     * runs when the second changes.
      */
-    static void info(const std::string& message) {
-      LogEntry logEntry;
-      logEntry.type = INFO;
-      logEntry.message = "[" + getTimestamp() + "] INFO: " + message;
-      m_messages.push_back(logEntry);
+    const char* formatTimestamp(int64_t timestamp) {
+      const int64_t second = timestamp / 1000000000;
+      if (second != m_timestampSecond) {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm localTime;
+#ifdef _WIN32
+        localtime_s(&localTime, &time);
+#else
+        localtime_r(&time, &localTime);
+#endif
+        std::strftime(m_timestamp, sizeof(m_timestamp), "%Y-%m-%dT%H:%M:%S",
+                      &localTime);
+        m_timestampSecond = second;
+      }
+      return m_timestamp;
+    }
+
+    void write(const LogEntry& entry) {
+      const std::string* color = &GREEN;
+      const char* label = "INFO";
+      if (entry.type == WARNING) {
+        color = &YELLOW;
+        label = "WARNING";
+      } else if (entry.type == ERROR) {
+        color = &RED;
+        label = "ERROR";
+      }
+
+      std::fprintf(stdout, "%s[%s] %s: %.*s%s\n", color->c_str(),
+                   formatTimestamp(entry.timestamp), label,
+                   static_cast<int>(entry.length), entry.message,
+                   RESET.c_str());
+    }
 
-      std::cout << GREEN << logEntry.message << RESET << std::endl;
+    // Background thread: writes every pending entry, flushing once per batch.
+    void drainLoop() {
+      LogEntry entry;
+      for (;;) {
+        bool hasWritten = false;
+        while (m_buffer.tryPop(entry)) {
+          write(entry);
+          hasWritten = true;
+        }
+        if (hasWritten) {
+          std::fflush(stdout);
+        } else if (!m_isRunning.load()) {
+          return;
+        } else {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
     }
 
-    static void error(const std::string& message) {
-      LogEntry logEntry;
-      logEntry.type = ERROR;
-      logEntry.message = "[" + getTimestamp() + "] ERROR: " + message;
-      m_messages.push_back(logEntry);
+  public:
+    /**
+     * Sets the ring buffer capacity (in entries) and the overflow policy. Only
+     * has effect if called before the first message is logged.
+     */
+    static void configure(size_t capacity, LogOverflowPolicy policy) {
+      configuredCapacity() = capacity;
+      configuredPolicy() = policy;
+    }
 
-      std::cout << RED << logEntry.message << RESET << std::endl;
+    // Number of messages dropped or overwritten because the buffer was full.
+    static uint64_t getNumLost() {
+      return getInstance().m_numLost.load(std::memory_order_relaxed);
     }
 
     /**
-     * Logs a warning message. The message is prefixed with a timestamp and the
-     * "WARNING" label. The log entry is then added to the list of messages and
-     * printed to the console with a yellow color.
+     * Logs an informational message. The message is stored with its timestamp
+     * and printed by the background thread in green color with the "INFO"
+     * label.
      */
-    void warning(const std::string& message) {
-      LogEntry logEntry;
-      logEntry.type = WARNING;
-      logEntry.message = "[" + getTimestamp() + "] WARNING: " + message;
-      m_messages.push_back(logEntry);
+    static void info(std::string_view message) {
+      getInstance().push(INFO, message);
+    }
+
+    static void error(std::string_view message) {
+      getInstance().push(ERROR, message);
+    }
 
-      std::cout << YELLOW << logEntry.message << RESET << std::endl;
+    /**
+     * Logs a warning message. The message is stored with its timestamp and
+     * printed by the background thread in yellow color with the "WARNING"
+     * label.
+     */
+    static void warning(std::string_view message) {
+      getInstance().push(WARNING, message);
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,115 @@
+#include "../render/NullRenderDevice.hpp"
+#include "../render/RecordingRenderDevice.hpp"
+#include "../render/SoftwareRenderDevice.hpp"
+#include <cstdint>
+#include <iostream>
+
+/*
+ * Captures a few frames with a `RecordingRenderDevice` and checks that the
+ * replay sends the same commands, and draws the same pixels when the captured
+ * textures are blank (replays recreate textures as blank render targets):
+ *
+ *   make test-recording
+ */
+
+const int FRAME_WIDTH = 160;
+const int FRAME_HEIGHT = 120;
+
+// Three frames drawing a sprite into a render target, then both to the screen.
+void drawFrames(RenderDevice& device) {
+  SDL_Surface* surface =
+      SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+  const TextureHandle sprite = device.createTexture(surface);
+  SDL_FreeSurface(surface);
+  const TextureHandle target = device.createRenderTarget(64, 64);
+
+  for (int frame = 0; frame < 3; frame++) {
+    const uint8_t shade = static_cast<uint8_t>(60 * frame);
+    SpriteQuad spriteQuads[2] = {
+        {{0, 0, 16, 16}, {4.0f + frame, 4.0f, 32.0f, 32.0f}, 0.0},
+        {{4, 4, 8, 8}, {20.0f, 30.0f, 24.0f, 16.0f}, 30.0 * frame}};
+    device.setRenderTarget(target);
+    device.clear({shade, 40, 200, 160});
+    device.drawQuads(sprite, spriteQuads, 2);
+
+    SpriteQuad targetQuads[2] = {
+        {{0, 0, 64, 64}, {10.0f, 10.0f, 64.0f, 64.0f}, 0.0},
+        {{16, 16, 32, 32}, {90.0f, 40.0f, 48.0f, 48.0f}, 45.0,
+         {255, 128, 64, 200}}};
+    device.setRenderTarget(NULL_TEXTURE);
+    device.clear({21, 21, 21, 255});
+    device.drawQuads(target, targetQuads, 2);
+    device.drawQuads(sprite, spriteQuads, 1);
+    device.present();
+  }
+
+  device.destroyTexture(target);
+  device.destroyTexture(sprite);
+}
+
+bool checkCounter(const char* name, uint64_t recorded, uint64_t replayed) {
+  if (recorded == replayed) {
+    return true;
+  }
+  std::cout << name << ": " << replayed << " replayed instead of " << recorded
+            << std::endl;
+  return false;
+}
+
+// Same commands on a null device, live and replayed.
+bool checkCommands() {
+  NullRenderDevice live;
+  RecordingRenderDevice recorder(&live);
+  drawFrames(recorder);
+
+  NullRenderDevice replayed;
+  recorder.getCapture().replay(replayed);
+
+  const RenderDeviceCounters& a = live.getCounters();
+  const RenderDeviceCounters& b = replayed.getCounters();
+  bool isSame = checkCounter("textures created", a.numTexturesCreated,
+                             b.numTexturesCreated);
+  isSame &= checkCounter("textures destroyed", a.numTexturesDestroyed,
+                         b.numTexturesDestroyed);
+  isSame &= checkCounter("target switches", a.numTargetSwitches,
+                         b.numTargetSwitches);
+  isSame &= checkCounter("clears", a.numClears, b.numClears);
+  isSame &= checkCounter("draw calls", a.numDrawCalls, b.numDrawCalls);
+  isSame &= checkCounter("texture switches", a.numTextureSwitches,
+                         b.numTextureSwitches);
+  isSame &= checkCounter("quads", a.numQuads, b.numQuads);
+  isSame &= checkCounter("presents", a.numPresents, b.numPresents);
+  std::cout << "commands: " << (isSame ? "ok" : "different") << " ("
+            << recorder.getCapture().commands.size() << " recorded)"
+            << std::endl;
+  return isSame;
+}
+
+// Same pixels on software devices: the sprite surface is blank, like replays.
+bool checkPixels() {
+  SoftwareRenderDevice live(FRAME_WIDTH, FRAME_HEIGHT, 1);
+  RecordingRenderDevice recorder(&live);
+  drawFrames(recorder);
+
+  SoftwareRenderDevice replayed(FRAME_WIDTH, FRAME_HEIGHT, 1);
+  recorder.getCapture().replay(replayed);
+
+  const auto& expected = live.getFramebuffer().pixels;
+  const auto& pixels = replayed.getFramebuffer().pixels;
+  size_t numDifferent = 0;
+  for (size_t i = 0; i < pixels.size(); i++) {
+    numDifferent += pixels[i] != expected[i];
+  }
+  if (numDifferent == 0) {
+    std::cout << "pixels: ok" << std::endl;
+    return true;
+  }
+  std::cout << "pixels: " << numDifferent << " differ" << std::endl;
+  return false;
+}
+
+int main() {
+  const bool isCommandsOk = checkCommands();
+  const bool isPixelsOk = checkPixels();
+  return isCommandsOk && isPixelsOk ? 0 : 1;
+}
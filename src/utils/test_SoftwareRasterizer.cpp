@@ -0,0 +1,310 @@
+#include "../render/SoftwareRasterizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+/*
+ * Checks that the software rasterizer draws the same pixels with every blending
+ * code path (scalar, SSE2, AVX2) and any number of threads, and close enough to
+ * SDL's own software renderer for golden-image tests:
+ *
+ *   make test-rasterizer
+ *
+ * The framebuffer size is not a multiple of the tile size or of the SIMD
+ * widths, so partial tiles and span tails are covered too.
+ */
+
+const int FRAME_WIDTH = 301;
+const int FRAME_HEIGHT = 203;
+const int NUM_QUADS = 600;
+
+/*
+ * Against SDL, a pixel differs if one of its channels is off by more than
+ * SDL_CHANNEL_TOLERANCE; at most SDL_MAX_DIFFERENT_PIXELS may differ. The
+ * blending math is the same, so the differences are texels sampled across a
+ * boundary and quad edges rounded to the other side of a pixel center.
+ */
+const int SDL_CHANNEL_TOLERANCE = 2;
+const size_t SDL_MAX_DIFFERENT_PIXELS = FRAME_WIDTH * FRAME_HEIGHT / 50;
+
+struct SceneQuad {
+    size_t texture;
+    SDL_Rect srcRect;
+    SDL_FRect dstRect;
+    double rotation;
+    SDL_Color color;
+};
+
+uint32_t nextRandom(uint32_t& state) {
+  // xorshift32: the same scene on every run and platform
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+int randomInt(uint32_t& state, int min, int max) {
+  return min + static_cast<int>(nextRandom(state) % (max - min + 1));
+}
+
+std::vector<SoftwareTexture> makeTextures() {
+  uint32_t state = 7;
+  std::vector<SoftwareTexture> textures;
+  const int sizes[][2] = {{32, 32}, {7, 13}, {64, 16}};
+  for (const auto& size : sizes) {
+    SoftwareTexture texture(size[0], size[1]);
+    for (auto& pixel : texture.pixels) {
+      pixel = nextRandom(state);
+      // plenty of fully transparent and opaque texels: the ends of the blend
+      // ranges, where rounding errors would show first
+      const uint32_t alpha = nextRandom(state) % 4;
+      if (alpha == 0) {
+        pixel &= 0x00ffffff;
+      } else if (alpha == 1) {
+        pixel |= 0xff000000;
+      }
+    }
+    textures.push_back(texture);
+  }
+  return textures;
+}
+
+std::vector<SceneQuad> makeScene(const std::vector<SoftwareTexture>& textures) {
+  uint32_t state = 42;
+  std::vector<SceneQuad> scene;
+  for (int i = 0; i < NUM_QUADS; i++) {
+    SceneQuad quad;
+    quad.texture = nextRandom(state) % textures.size();
+    const SoftwareTexture& texture = textures[quad.texture];
+    quad.srcRect.x = randomInt(state, 0, texture.width - 1);
+    quad.srcRect.y = randomInt(state, 0, texture.height - 1);
+    quad.srcRect.w = randomInt(state, 1, texture.width - quad.srcRect.x);
+    quad.srcRect.h = randomInt(state, 1, texture.height - quad.srcRect.y);
+
+    quad.dstRect = {
+        static_cast<float>(randomInt(state, -60, FRAME_WIDTH)) + 0.25f,
+        static_cast<float>(randomInt(state, -60, FRAME_HEIGHT)) + 0.5f,
+        static_cast<float>(randomInt(state, 1, 120)),
+        static_cast<float>(randomInt(state, 1, 120))};
+    quad.rotation = i % 3 == 0 ? 0.0 : randomInt(state, 0, 359);
+    const uint32_t color = nextRandom(state);
+    quad.color = {static_cast<uint8_t>(color),
+                  static_cast<uint8_t>(color >> 8),
+                  static_cast<uint8_t>(color >> 16),
+                  static_cast<uint8_t>(color >> 24)};
+    scene.push_back(quad);
+  }
+  return scene;
+}
+
+void drawScene(SoftwareRasterizer& rasterizer,
+               const std::vector<SoftwareTexture>& textures,
+               const std::vector<SceneQuad>& scene) {
+  rasterizer.clear({21, 21, 21, 255});
+  for (const SceneQuad& quad : scene) {
+    rasterizer.drawQuad(textures[quad.texture], quad.srcRect, quad.dstRect,
+                        quad.rotation, quad.color);
+  }
+  rasterizer.flush();
+}
+
+/*
+ * Draws the scene with SDL's software renderer, as `SdlRenderDevice` would:
+ * unrotated quads are copied, rotated ones are triangles with the color mod in
+ * their vertices. Returns the ARGB8888 pixels, or nothing on SDL errors.
+ */
+std::vector<uint32_t> drawSdlScene(const std::vector<SoftwareTexture>& textures,
+                                   const std::vector<SceneQuad>& scene) {
+  std::vector<uint32_t> pixels;
+  SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(
+      0, FRAME_WIDTH, FRAME_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+  SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+  if (!renderer) {
+    std::cout << "sdl: " << SDL_GetError() << std::endl;
+    SDL_FreeSurface(target);
+    return pixels;
+  }
+
+  std::vector<SDL_Texture*> sdlTextures;
+  for (const SoftwareTexture& texture : textures) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(
+        0, texture.width, texture.height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Texture* sdlTexture = NULL;
+    if (surface) {
+      for (int y = 0; y < texture.height; y++) {
+        std::memcpy(static_cast<uint8_t*>(surface->pixels) + y * surface->pitch,
+                    &texture.pixels[static_cast<size_t>(y) * texture.width],
+                    static_cast<size_t>(texture.width) * sizeof(uint32_t));
+      }
+      sdlTexture = SDL_CreateTextureFromSurface(renderer, surface);
+      SDL_FreeSurface(surface);
+    }
+    if (sdlTexture) {
+      SDL_SetTextureBlendMode(sdlTexture, SDL_BLENDMODE_BLEND);
+      SDL_SetTextureScaleMode(sdlTexture, SDL_ScaleModeNearest);
+    }
+    sdlTextures.push_back(sdlTexture);
+  }
+
+  SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
+  SDL_RenderClear(renderer);
+  for (const SceneQuad& quad : scene) {
+    SDL_Texture* texture = sdlTextures[quad.texture];
+    if (!texture) {
+      continue;
+    }
+    if (quad.rotation == 0.0) {
+      SDL_SetTextureColorMod(texture, quad.color.r, quad.color.g,
+                             quad.color.b);
+      SDL_SetTextureAlphaMod(texture, quad.color.a);
+      SDL_RenderCopyExF(renderer, texture, &quad.srcRect, &quad.dstRect,
+                        quad.rotation, NULL, SDL_FLIP_NONE);
+      continue;
+    }
+
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(texture, 255);
+    const SoftwareTexture& source = textures[quad.texture];
+    const float u0 = static_cast<float>(quad.srcRect.x) / source.width;
+    const float v0 = static_cast<float>(quad.srcRect.y) / source.height;
+    const float u1 =
+        static_cast<float>(quad.srcRect.x + quad.srcRect.w) / source.width;
+    const float v1 =
+        static_cast<float>(quad.srcRect.y + quad.srcRect.h) / source.height;
+    const float radians = static_cast<float>(quad.rotation * M_PI / 180.0);
+    const float cosine = std::cos(radians);
+    const float sine = std::sin(radians);
+    const float halfWidth = quad.dstRect.w * 0.5f;
+    const float halfHeight = quad.dstRect.h * 0.5f;
+    const float centerX = quad.dstRect.x + halfWidth;
+    const float centerY = quad.dstRect.y + halfHeight;
+    const float offsets[4][2] = {{-halfWidth, -halfHeight},
+                                 {halfWidth, -halfHeight},
+                                 {halfWidth, halfHeight},
+                                 {-halfWidth, halfHeight}};
+    const float texCoords[4][2] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+    SDL_Vertex vertices[4];
+    for (int i = 0; i < 4; i++) {
+      vertices[i].position = {
+          centerX + offsets[i][0] * cosine - offsets[i][1] * sine,
+          centerY + offsets[i][0] * sine + offsets[i][1] * cosine};
+      vertices[i].color = quad.color;
+      vertices[i].tex_coord = {texCoords[i][0], texCoords[i][1]};
+    }
+    const int indices[6] = {0, 1, 2, 2, 3, 0};
+    SDL_RenderGeometry(renderer, texture, vertices, 4, indices, 6);
+  }
+
+  pixels.resize(static_cast<size_t>(FRAME_WIDTH) * FRAME_HEIGHT);
+  if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888,
+                           pixels.data(), FRAME_WIDTH * sizeof(uint32_t)) != 0) {
+    std::cout << "sdl: " << SDL_GetError() << std::endl;
+    pixels.clear();
+  }
+
+  for (SDL_Texture* texture : sdlTextures) {
+    if (texture) {
+      SDL_DestroyTexture(texture);
+    }
+  }
+  SDL_DestroyRenderer(renderer);
+  SDL_FreeSurface(target);
+  return pixels;
+}
+
+// Largest difference between two ARGB8888 pixels over their channels.
+int getChannelDifference(uint32_t a, uint32_t b) {
+  int difference = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    const int channelA = static_cast<int>((a >> shift) & 0xff);
+    const int channelB = static_cast<int>((b >> shift) & 0xff);
+    difference = std::max(difference, std::abs(channelA - channelB));
+  }
+  return difference;
+}
+
+// Compares the scalar output with SDL's, within the tolerances above.
+bool checkAgainstSdl(const std::vector<SoftwareTexture>& textures,
+                     const std::vector<SceneQuad>& scene,
+                     const std::vector<uint32_t>& pixels) {
+  const std::vector<uint32_t> expected = drawSdlScene(textures, scene);
+  if (expected.size() != pixels.size()) {
+    std::cout << "sdl: could not render the scene" << std::endl;
+    return false;
+  }
+
+  size_t numDifferent = 0;
+  int maxDifference = 0;
+  for (size_t i = 0; i < pixels.size(); i++) {
+    const int difference = getChannelDifference(pixels[i], expected[i]);
+    if (difference > SDL_CHANNEL_TOLERANCE) {
+      numDifferent++;
+    }
+    maxDifference = std::max(maxDifference, difference);
+  }
+
+  std::cout << "sdl software renderer: " << numDifferent << " of "
+            << pixels.size() << " pixels off by more than "
+            << SDL_CHANNEL_TOLERANCE << " (at most " << SDL_MAX_DIFFERENT_PIXELS
+            << " allowed), largest difference " << maxDifference << std::endl;
+  return numDifferent <= SDL_MAX_DIFFERENT_PIXELS;
+}
+
+int main() {
+  const std::vector<SoftwareTexture> textures = makeTextures();
+  const std::vector<SceneQuad> scene = makeScene(textures);
+
+  SoftwareRasterizer reference(FRAME_WIDTH, FRAME_HEIGHT, 1);
+  reference.setBlendPath(RASTER_BLEND_SCALAR);
+  drawScene(reference, textures, scene);
+  const std::vector<uint32_t>& expected = reference.getFramebuffer().pixels;
+
+  const RasterBlendPath paths[] = {RASTER_BLEND_SCALAR, RASTER_BLEND_SSE2,
+                                   RASTER_BLEND_AVX2};
+  const char* pathNames[] = {"scalar", "sse2", "avx2"};
+  const unsigned threadCounts[] = {1, 2, 3, 8};
+  int numFailures = checkAgainstSdl(textures, scene, expected) ? 0 : 1;
+
+  for (int path = 0; path < 3; path++) {
+    for (unsigned numThreads : threadCounts) {
+      SoftwareRasterizer rasterizer(FRAME_WIDTH, FRAME_HEIGHT, numThreads);
+      if (!rasterizer.setBlendPath(paths[path])) {
+        std::cout << pathNames[path] << ": not supported, skipped"
+                  << std::endl;
+        break;
+      }
+      drawScene(rasterizer, textures, scene);
+
+      const std::vector<uint32_t>& pixels = rasterizer.getFramebuffer().pixels;
+      size_t numDifferent = 0;
+      size_t firstDifferent = 0;
+      for (size_t i = 0; i < pixels.size(); i++) {
+        if (pixels[i] != expected[i]) {
+          if (numDifferent == 0) {
+            firstDifferent = i;
+          }
+          numDifferent++;
+        }
+      }
+
+      std::cout << pathNames[path] << ", " << numThreads << " threads: ";
+      if (numDifferent == 0) {
+        std::cout << "ok (" << rasterizer.getNumPixels() << " pixels)"
+                  << std::endl;
+        continue;
+      }
+      std::cout << numDifferent << " pixels differ, first at ("
+                << firstDifferent % FRAME_WIDTH << ", "
+                << firstDifferent / FRAME_WIDTH << "): " << std::hex
+                << pixels[firstDifferent] << " instead of "
+                << expected[firstDifferent] << std::dec << std::endl;
+      numFailures++;
+    }
+  }
+
+  return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+#include "../src/AssetArchive.hpp"
+#include "spdlog/spdlog.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <system_error>
+#include <vector>
+
+/*
+ * Packs the textures, tilemaps and sounds under a directory into an asset
+ * archive (see `AssetArchive`), so the game maps one file at startup instead
+ * of opening and decoding each asset:
+ *
+ *   flatland-pack <assets directory> <archive>
+ *
+ * Images are decoded here and stored as RGBA32 pixels, the format the
+ * `AssetStore` atlases are built in; tilemaps and sounds are stored as is.
+ * Other files (fonts) are left out and still read from the directory.
+ */
+
+namespace fs = std::filesystem;
+
+struct PackedAsset {
+    std::string name;
+    ArchiveEntry entry;
+    std::vector<uint8_t> data;
+};
+
+static bool hasExtension(const fs::path& path,
+                         std::initializer_list<const char*> extensions) {
+  std::string extension = path.extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  for (const char* candidate : extensions) {
+    if (extension == candidate) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool readFile(const fs::path& path, std::vector<uint8_t>& data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    spdlog::error("[AssetPacker] Failed to open {}", path.string());
+    return false;
+  }
+  data.assign(std::istreambuf_iterator<char>(file),
+              std::istreambuf_iterator<char>());
+  return true;
+}
+
+static bool readTexture(const fs::path& path, PackedAsset& asset) {
+  SDL_Surface* image = IMG_Load(path.string().c_str());
+  if (!image) {
+    spdlog::error("[AssetPacker] Failed to load texture {}: {}",
+                  path.string(), IMG_GetError());
+    return false;
+  }
+  SDL_Surface* pixels =
+      SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(image);
+  if (!pixels) {
+    spdlog::error("[AssetPacker] Failed to convert texture {}: {}",
+                  path.string(), SDL_GetError());
+    return false;
+  }
+
+  // rows packed tightly, without the surface pitch padding
+  const size_t rowSize = static_cast<size_t>(pixels->w) * 4;
+  asset.data.resize(rowSize * pixels->h);
+  SDL_LockSurface(pixels);
+  const uint8_t* row = static_cast<const uint8_t*>(pixels->pixels);
+  for (int y = 0; y < pixels->h; y++, row += pixels->pitch) {
+    std::memcpy(&asset.data[y * rowSize], row, rowSize);
+  }
+  SDL_UnlockSurface(pixels);
+  asset.entry.width = static_cast<uint32_t>(pixels->w);
+  asset.entry.height = static_cast<uint32_t>(pixels->h);
+  SDL_FreeSurface(pixels);
+  return true;
+}
+
+static uint64_t alignOffset(uint64_t offset) {
+  return (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT *
+         ARCHIVE_ALIGNMENT;
+}
+
+static bool writeArchive(const std::string& filePath,
+                         std::vector<PackedAsset>& assets) {
+  std::string names;
+  for (auto& asset : assets) {
+    asset.entry.nameOffset = static_cast<uint32_t>(names.size());
+    asset.entry.nameSize = static_cast<uint32_t>(asset.name.size());
+    names += asset.name;
+  }
+
+  ArchiveHeader header = {};
+  std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+  header.version = ARCHIVE_VERSION;
+  header.numEntries = static_cast<uint32_t>(assets.size());
+  header.namesSize = static_cast<uint32_t>(names.size());
+
+  uint64_t offset = sizeof(ArchiveHeader) +
+                    assets.size() * sizeof(ArchiveEntry) + names.size();
+  for (auto& asset : assets) {
+    offset = alignOffset(offset);
+    asset.entry.offset = offset;
+    asset.entry.size = asset.data.size();
+    offset += asset.data.size();
+  }
+
+  std::ofstream file(filePath, std::ios::binary);
+  if (!file) {
+    spdlog::error("[AssetPacker] Failed to open {}", filePath);
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto& asset : assets) {
+    file.write(reinterpret_cast<const char*>(&asset.entry),
+               sizeof(asset.entry));
+  }
+  file.write(names.data(), names.size());
+  const char padding[ARCHIVE_ALIGNMENT] = {};
+  for (const auto& asset : assets) {
+    const uint64_t position = static_cast<uint64_t>(file.tellp());
+    file.write(padding, alignOffset(position) - position);
+    file.write(reinterpret_cast<const char*>(asset.data.data()),
+               asset.data.size());
+  }
+  if (!file) {
+    spdlog::error("[AssetPacker] Failed to write {}", filePath);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    std::fprintf(stderr, "usage: %s <assets directory> <archive>\n", argv[0]);
+    return 1;
+  }
+  const fs::path root = argv[1];
+  if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) == 0) {
+    spdlog::error("Error initializing SDL_image: {}", IMG_GetError());
+    return 1;
+  }
+
+  std::vector<fs::path> files;
+  std::error_code error;
+  for (fs::recursive_directory_iterator it(root, error), end;
+       !error && it != end; it.increment(error)) {
+    if (it->is_regular_file()) {
+      files.push_back(it->path());
+    }
+  }
+  if (error) {
+    spdlog::error("[AssetPacker] Failed to list {}: {}", root.string(),
+                  error.message());
+    return 1;
+  }
+  // the same directory always gives the same archive
+  std::sort(files.begin(), files.end());
+
+  std::vector<PackedAsset> assets;
+  for (const auto& path : files) {
+    PackedAsset asset = {};
+    asset.name = path.lexically_relative(root).generic_string();
+    bool isRead;
+    if (hasExtension(path, {".png", ".jpg", ".jpeg", ".bmp", ".tga"})) {
+      asset.entry.type = ARCHIVE_TEXTURE;
+      isRead = readTexture(path, asset);
+    } else if (hasExtension(path, {".map"})) {
+      asset.entry.type = ARCHIVE_TILEMAP;
+      isRead = readFile(path, asset.data);
+    } else if (hasExtension(path, {".wav", ".ogg", ".mp3"})) {
+      asset.entry.type = ARCHIVE_AUDIO;
+      isRead = readFile(path, asset.data);
+    } else {
+      spdlog::info("[AssetPacker] Skipped {}", asset.name);
+      continue;
+    }
+    if (!isRead) {
+      IMG_Quit();
+      return 1;
+    }
+    spdlog::info("[AssetPacker] Packed {} ({} bytes)", asset.name,
+                 asset.data.size());
+    assets.push_back(std::move(asset));
+  }
+
+  const bool isWritten = writeArchive(argv[2], assets);
+  IMG_Quit();
+  if (!isWritten) {
+    return 1;
+  }
+  spdlog::info("[AssetPacker] Wrote {} assets to {}", assets.size(), argv[2]);
+  return 0;
+}